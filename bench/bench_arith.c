@@ -0,0 +1,194 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "arith.h"
+
+/*
+    Checks the `^` lowering helpers, then times arith_ipow against the
+    one-multiply-per-step loop a naive lowering would emit.
+
+    Checked:
+      - arith_ipow: every base in [-40, 40] and exponent in [0, 70] against
+        repeated multiplication with an independent overflow test, plus the
+        int64 edges ((-2)^63, 2^63, 3^39, 3^40, huge exponents) and negative
+        exponents (only 1 and -1 stay integral)
+      - arith_powi: exact float cases, negative exponents, INT64_MIN
+      - arith_pow_chain: the steps rebuild every exponent up to 4096, within
+        2*log2(exp) multiplies
+
+    JSON on stdout; each failed check is reported on stderr and the exit
+    code is 1.
+*/
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static size_t checks;
+static size_t failures;
+
+static void expect(int cond, const char *what, long long a, long long b) {
+    checks++;
+    if (cond) return;
+    failures++;
+    fprintf(stderr, "error: %s (%lld, %lld)\n", what, a, b);
+}
+
+// a * b on magnitudes, so it shares nothing with arith.c's overflow test
+static int ref_mul(int64_t a, int64_t b, int64_t *out) {
+    uint64_t ma = a < 0 ? 0u - (uint64_t)a : (uint64_t)a;
+    uint64_t mb = b < 0 ? 0u - (uint64_t)b : (uint64_t)b;
+    if (ma && mb > UINT64_MAX / ma) return 0;
+    uint64_t m = ma * mb;
+    if ((a < 0) != (b < 0) && m) {
+        if (m > (uint64_t)INT64_MAX + 1u) return 0;
+        *out = m == (uint64_t)INT64_MAX + 1u ? INT64_MIN : -(int64_t)m;
+    } else {
+        if (m > (uint64_t)INT64_MAX) return 0;
+        *out = (int64_t)m;
+    }
+    return 1;
+}
+
+static ArithStatus ref_ipow(int64_t base, int64_t exp, int64_t *out) {
+    int64_t r = 1;
+    for (int64_t k = 0; k < exp; k++) {
+        if (!ref_mul(r, base, &r)) return ARITH_OVERFLOW;
+    }
+    *out = r;
+    return ARITH_OK;
+}
+
+static void check_ipow(void) {
+    for (int64_t base = -40; base <= 40; base++) {
+        for (int64_t exp = 0; exp <= 70; exp++) {
+            int64_t want = 0, got = 0;
+            ArithStatus ws = ref_ipow(base, exp, &want);
+            ArithStatus gs = arith_ipow(base, exp, &got);
+            expect(ws == gs && (gs != ARITH_OK || want == got), "arith_ipow disagrees with repeated multiplication", (long long)base, (long long)exp);
+        }
+    }
+
+    int64_t v = 0;
+    expect(arith_ipow(-2, 63, &v) == ARITH_OK && v == INT64_MIN, "(-2)^63 is INT64_MIN", -2, 63);
+    expect(arith_ipow(2, 63, &v) == ARITH_OVERFLOW, "2^63 overflows", 2, 63);
+    expect(arith_ipow(2, 62, &v) == ARITH_OK && v == (int64_t)1 << 62, "2^62 fits", 2, 62);
+    expect(arith_ipow(3, 39, &v) == ARITH_OK && v == 4052555153018976267LL, "3^39 fits", 3, 39);
+    expect(arith_ipow(3, 40, &v) == ARITH_OVERFLOW, "3^40 overflows", 3, 40);
+    expect(arith_ipow(INT64_MIN, 1, &v) == ARITH_OK && v == INT64_MIN, "INT64_MIN^1", 0, 1);
+    expect(arith_ipow(INT64_MIN, 2, &v) == ARITH_OVERFLOW, "INT64_MIN^2 overflows", 0, 2);
+    expect(arith_ipow(2, INT64_MAX, &v) == ARITH_OVERFLOW, "2^INT64_MAX overflows", 2, INT64_MAX);
+    expect(arith_ipow(-1, INT64_MAX, &v) == ARITH_OK && v == -1, "(-1)^INT64_MAX", -1, INT64_MAX);
+    expect(arith_ipow(0, 0, &v) == ARITH_OK && v == 1, "0^0 is 1", 0, 0);
+
+    // negative exponents: only 1 and -1 stay integral, and *out is untouched otherwise
+    expect(arith_ipow(1, -5, &v) == ARITH_OK && v == 1, "1^-5", 1, -5);
+    expect(arith_ipow(-1, -3, &v) == ARITH_OK && v == -1, "(-1)^-3", -1, -3);
+    expect(arith_ipow(-1, -4, &v) == ARITH_OK && v == 1, "(-1)^-4", -1, -4);
+    expect(arith_ipow(-1, INT64_MIN, &v) == ARITH_OK && v == 1, "(-1)^INT64_MIN", -1, INT64_MIN);
+    v = 7;
+    expect(arith_ipow(2, -1, &v) == ARITH_NEG_EXPONENT && v == 7, "2^-1 is not an integer", 2, -1);
+    expect(arith_ipow(0, -1, &v) == ARITH_NEG_EXPONENT && v == 7, "0^-1 is not an integer", 0, -1);
+    expect(arith_ipow(10, INT64_MIN, &v) == ARITH_NEG_EXPONENT && v == 7, "10^INT64_MIN", 10, INT64_MIN);
+}
+
+static void check_powi(void) {
+    // powers of two and small integers: every result below is exact
+    for (int64_t exp = -60; exp <= 60; exp++) {
+        double want = 1.0;
+        for (int64_t k = 0; k < (exp < 0 ? -exp : exp); k++) want *= 2.0;
+        if (exp < 0) want = 1.0 / want;
+        expect(arith_powi(2.0, exp) == want, "arith_powi(2, exp)", 2, (long long)exp);
+    }
+    expect(arith_powi(1.5, 3) == 3.375, "1.5^3", 0, 3);
+    expect(arith_powi(-3.0, 5) == -243.0, "(-3)^5", -3, 5);
+    expect(arith_powi(-2.0, -3) == -0.125, "(-2)^-3", -2, -3);
+    expect(arith_powi(7.0, 0) == 1.0, "7^0", 7, 0);
+    expect(arith_powi(0.0, 0) == 1.0, "0^0", 0, 0);
+    expect(arith_powi(2.0, INT64_MIN) == 0.0, "2^INT64_MIN underflows to 0", 2, INT64_MIN);
+    expect(arith_powi(1.0, INT64_MIN) == 1.0, "1^INT64_MIN", 1, INT64_MIN);
+}
+
+static void check_pow_chain(void) {
+    PowStep steps[128];
+    expect(arith_pow_chain(1, steps) == 0, "x^1 needs no steps", 1, 0);
+
+    for (uint64_t exp = 1; exp <= 4096; exp++) {
+        size_t n = arith_pow_chain(exp, steps);
+        uint64_t acc = 1; // exponent of x held by acc
+        for (size_t k = 0; k < n; k++) acc = steps[k] == POW_STEP_SQUARE ? acc * 2 : acc + 1;
+
+        size_t log2 = 0;
+        while ((exp >> (log2 + 1)) != 0) log2++;
+        expect(acc == exp && n <= 2 * log2, "arith_pow_chain rebuilds exp", (long long)exp, (long long)n);
+    }
+
+    size_t n = arith_pow_chain(UINT64_MAX, steps);
+    expect(n == 126, "x^(2^64-1) takes 63 squares and 63 multiplies", -1, (long long)n);
+}
+
+// the checksums keep the compiler from dropping the loops
+static uint64_t sink;
+
+int main(int argc, char **argv) {
+    size_t calls = 2000000;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--calls") == 0 && a + 1 < argc) {
+            calls = (size_t)strtoull(argv[++a], NULL, 10);
+            if (!calls) calls = 1;
+        } else {
+            fprintf(stderr, "Usage: %s [--calls <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    check_ipow();
+    check_powi();
+    check_pow_chain();
+
+    printf("{\n");
+    printf("  \"benchmark\": \"integer_power\",\n");
+    printf("  \"checks\": %zu,\n", checks);
+    printf("  \"failures\": %zu,\n", failures);
+    printf("  \"calls\": %zu,\n", calls);
+    printf("  \"results\": [\n");
+
+    static const int64_t exps[] = { 2, 5, 13, 31, 62 };
+    size_t nexps = sizeof(exps) / sizeof(exps[0]);
+    for (size_t e = 0; e < nexps; e++) {
+        // base 2 or -2 so even 2^62 fits
+        double t0 = now_seconds();
+        for (size_t k = 0; k < calls; k++) {
+            int64_t v = 0;
+            arith_ipow((k & 1) ? 2 : -2, exps[e], &v);
+            sink += (uint64_t)v;
+        }
+        double ipow_ns = (now_seconds() - t0) * 1e9 / (double)calls;
+
+        t0 = now_seconds();
+        for (size_t k = 0; k < calls; k++) {
+            int64_t v = 0;
+            ref_ipow((k & 1) ? 2 : -2, exps[e], &v);
+            sink += (uint64_t)v;
+        }
+        double loop_ns = (now_seconds() - t0) * 1e9 / (double)calls;
+
+        printf("    {\"exp\": %lld, \"ipow_ns\": %.2f, \"repeated_mul_ns\": %.2f}%s\n",
+               (long long)exps[e], ipow_ns, loop_ns, e + 1 < nexps ? "," : "");
+    }
+    printf("  ],\n");
+    printf("  \"checksum\": %llu\n", (unsigned long long)sink);
+    printf("}\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "input.h"
+
+/*
+    Input builtin throughput. Either on stdin, e.g.
+
+        ./bench/bench_input --lines < /tmp/nums.txt
+        cat /tmp/nums.txt | ./bench/bench_input --ints   (buffered path)
+
+    or on a generated file of the numbers 1..n, one per line, read through
+    every mode plus a bare memchr newline count (what `wc -l` does):
+
+        ./bench/bench_input --synthetic 5000000
+
+    JSON on stdout.
+*/
+
+typedef enum Mode {
+    MODE_LINES,
+    MODE_INTS,
+    MODE_FLOATS
+} Mode;
+
+static const char *const MODE_NAMES[] = { "lines", "ints", "floats" };
+
+typedef struct Result {
+    int mapped;
+    size_t items;
+    size_t bad; // words that were not numbers, skipped
+    double seconds;
+    double checksum;
+} Result;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int run(int fd, Mode mode, Result *r) {
+    InputReader in;
+    if (!input_open_fd(&in, fd)) return 0;
+    memset(r, 0, sizeof(*r));
+    r->mapped = in.map.mapped;
+
+    double t0 = now_seconds();
+    if (mode == MODE_LINES) {
+        StrSlice line;
+        size_t bytes = 0;
+        while (input_read_line(&in, &line)) {
+            r->items++;
+            bytes += line.len + 1;
+        }
+        r->checksum = (double)bytes;
+    } else if (mode == MODE_INTS) {
+        int64_t v;
+        int got;
+        while ((got = input_read_int(&in, &v)) != 0) {
+            if (got < 0) {
+                r->bad++;
+                continue;
+            }
+            r->items++;
+            r->checksum += (double)v;
+        }
+    } else {
+        double v;
+        int got;
+        while ((got = input_read_float(&in, &v)) != 0) {
+            if (got < 0) {
+                r->bad++;
+                continue;
+            }
+            r->items++;
+            r->checksum += v;
+        }
+    }
+    r->seconds = now_seconds() - t0;
+
+    input_close(&in);
+    return 1;
+}
+
+static void print_result(const char *name, const Result *r, const char *sep) {
+    printf("    {\"mode\": \"%s\", \"stdin\": \"%s\", \"items\": %zu, \"bad\": %zu, \"seconds\": %.6f, "
+           "\"items_per_s\": %.0f, \"checksum\": %.17g}%s\n",
+           name, r->mapped ? "mmap" : "buffered", r->items, r->bad, r->seconds,
+           r->seconds > 0 ? (double)r->items / r->seconds : 0.0, r->checksum, sep);
+}
+
+// the floor for line reading: count newlines in the mapping and nothing else
+static double newline_scan(int fd, size_t *lines) {
+    MappedFile mf;
+    *lines = 0;
+    if (!map_fd(fd, &mf)) return 0.0;
+
+    double t0 = now_seconds();
+    const uint8_t *p = mf.data;
+    const uint8_t *end = mf.data + mf.size;
+    while ((p = (const uint8_t *)memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        (*lines)++;
+        p++;
+    }
+    double dt = now_seconds() - t0;
+
+    unmap_file(&mf);
+    return dt;
+}
+
+static int synthetic(size_t n) {
+    char path[] = "/tmp/bench_input_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        fprintf(stderr, "error: could not create a temp file\n");
+        return 1;
+    }
+    unlink(path); // gone once fd is closed
+
+    FILE *f = fdopen(dup(fd), "w");
+    for (size_t k = 1; f && k <= n; k++) fprintf(f, "%zu\n", k);
+    if (!f || fclose(f) != 0) {
+        fprintf(stderr, "error: could not write the input file\n");
+        close(fd);
+        return 1;
+    }
+
+    Result r[3];
+    for (int m = 0; m < 3; m++) {
+        lseek(fd, 0, SEEK_SET);
+        if (!run(fd, (Mode)m, &r[m])) {
+            fprintf(stderr, "error: out of memory\n");
+            close(fd);
+            return 1;
+        }
+    }
+    size_t lines;
+    double scan = newline_scan(fd, &lines);
+    close(fd);
+
+    printf("{\n");
+    printf("  \"benchmark\": \"input_synthetic\",\n");
+    printf("  \"n\": %zu,\n", n);
+    printf("  \"newline_scan\": {\"lines\": %zu, \"seconds\": %.6f},\n", lines, scan);
+    printf("  \"results\": [\n");
+    for (int m = 0; m < 3; m++) print_result(MODE_NAMES[m], &r[m], m < 2 ? "," : "");
+    printf("  ]\n");
+    printf("}\n");
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 3 && strcmp(argv[1], "--synthetic") == 0) {
+        size_t n = (size_t)strtoull(argv[2], NULL, 10);
+        return synthetic(n ? n : 1);
+    }
+
+    const char *arg = argc > 1 ? argv[1] : "--lines";
+    int mode = -1;
+    for (int m = 0; m < 3; m++) {
+        if (strncmp(arg, "--", 2) == 0 && strcmp(arg + 2, MODE_NAMES[m]) == 0) mode = m;
+    }
+    if (argc > 2 || mode < 0) {
+        fprintf(stderr, "Usage: %s [--lines | --ints | --floats] < input\n"
+                        "       %s --synthetic <n>\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    Result r;
+    if (!run(0, (Mode)mode, &r)) {
+        fprintf(stderr, "error: out of memory\n");
+        return 1;
+    }
+
+    printf("{\n");
+    printf("  \"benchmark\": \"input_%s\",\n", MODE_NAMES[mode]);
+    printf("  \"results\": [\n");
+    print_result(MODE_NAMES[mode], &r, "");
+    printf("  ]\n");
+    printf("}\n");
+    return 0;
+}
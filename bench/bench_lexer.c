@@ -0,0 +1,128 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "corpus.h"
+#include "keywords.h"
+#include "lexer.h"
+
+/*
+    Lexer throughput harness.
+    Lexes a generated corpus (or --input file) several times with
+    lexer_next_token and reports the best run as JSON on stdout, e.g.
+
+        make bench > before.json
+        ... change the lexer ...
+        make bench > after.json
+
+    Parse/codegen throughput will be added here as those phases land.
+*/
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void print_usage(const char *progname) {
+    fprintf(stderr, "Usage: %s [--iterations <n>] [--input <file.cyl>] [corpus options]\n", progname);
+    corpus_print_options_help(stderr);
+}
+
+static int read_file(const char *path, StrBuf *out) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    char chunk[1 << 16];
+    size_t got;
+    int ok = 1;
+    while (ok && (got = fread(chunk, 1, sizeof(chunk), f)) > 0) ok = strbuf_append(out, chunk, got);
+    fclose(f);
+    return ok;
+}
+
+// returns token count (excluding EOF), or (size_t)-1 on a lexer error
+static size_t lex_all(const uint8_t *src, size_t len) {
+    Lexer lx;
+    lexer_init(&lx, "<bench>", src, len);
+    lexer_set_keyword_fn(&lx, lexer_default_is_keyword);
+
+    Token tok;
+    LexerStatus st;
+    size_t count = 0;
+    while ((st = lexer_next_token(&lx, &tok)) == LEX_OK) {
+        if (tok.type == TOK_STRING) free((void *)tok.value.str.ptr);
+        count++;
+    }
+    return st == LEX_EOF ? count : (size_t)-1;
+}
+
+int main(int argc, char **argv) {
+    CorpusOptions opts;
+    corpus_default_options(&opts);
+    int iterations = 5;
+    const char *input = NULL;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--iterations") == 0 && a + 1 < argc) {
+            iterations = atoi(argv[++a]);
+            if (iterations < 1) iterations = 1;
+            continue;
+        }
+        if (strcmp(argv[a], "--input") == 0 && a + 1 < argc) {
+            input = argv[++a];
+            continue;
+        }
+        int used = corpus_parse_option(&opts, argc, argv, a);
+        if (used <= 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        a += used - 1;
+    }
+
+    StrBuf src;
+    strbuf_init(&src);
+    int ok = input ? read_file(input, &src) : corpus_generate(&opts, &src);
+    if (!ok) {
+        fprintf(stderr, "error: could not %s corpus\n", input ? "read" : "generate");
+        strbuf_free(&src);
+        return 1;
+    }
+
+    double best = 0.0;
+    size_t tokens = 0;
+    for (int it = 0; it < iterations; it++) {
+        double t0 = now_seconds();
+        tokens = lex_all((const uint8_t *)src.data, src.len);
+        double dt = now_seconds() - t0;
+        if (tokens == (size_t)-1) {
+            fprintf(stderr, "error: corpus does not lex cleanly\n");
+            strbuf_free(&src);
+            return 2;
+        }
+        if (it == 0 || dt < best) best = dt;
+    }
+
+    double mb = (double)src.len / (1024.0 * 1024.0);
+    printf("{\n");
+    printf("  \"benchmark\": \"lexer_next_token\",\n");
+    if (input) printf("  \"input\": \"%s\",\n", input);
+    else { printf("  \"corpus\": "); corpus_options_json(&opts, stdout); printf(",\n"); }
+    printf("  \"bytes\": %zu,\n", src.len);
+    printf("  \"tokens\": %zu,\n", tokens);
+    printf("  \"iterations\": %d,\n", iterations);
+    printf("  \"best_seconds\": %.6f,\n", best);
+    printf("  \"mb_per_s\": %.2f,\n", best > 0 ? mb / best : 0.0);
+    printf("  \"tokens_per_s\": %.0f\n", best > 0 ? (double)tokens / best : 0.0);
+    printf("}\n");
+
+    strbuf_free(&src);
+    return 0;
+}
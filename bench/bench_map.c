@@ -0,0 +1,169 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "map.h"
+
+/*
+    Map lookup vs. the list-scan idiom users write today:
+
+        var i = 0
+        while i < len(keys) do
+            if keys[i] == k then ... end
+            var i = i + 1
+        end
+
+    For each size, builds n int keys and n string keys, then times
+    `lookups` random hits through CylMap and through a linear scan over
+    parallel key/value arrays. JSON on stdout.
+*/
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t next_rand(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+typedef struct Result {
+    double map_ns;
+    double scan_ns;
+} Result;
+
+// the checksums keep the compiler from dropping the lookups
+static uint64_t sink;
+
+static Result bench_int(size_t n, size_t lookups, uint64_t seed) {
+    int64_t *keys = (int64_t *)malloc(n * sizeof(int64_t));
+    uint64_t *values = (uint64_t *)malloc(n * sizeof(uint64_t));
+    size_t *order = (size_t *)malloc(lookups * sizeof(size_t));
+    CylMap m;
+    cyl_map_init(&m, CYL_MAP_INT, n);
+
+    for (size_t k = 0; k < n; k++) {
+        int inserted;
+        keys[k] = (int64_t)(next_rand(&seed) >> 16);
+        values[k] = k;
+        *cyl_map_upsert_int(&m, keys[k], &inserted) = k;
+    }
+    for (size_t k = 0; k < lookups; k++) order[k] = (size_t)(next_rand(&seed) % n);
+
+    Result r;
+    double t0 = now_seconds();
+    for (size_t k = 0; k < lookups; k++) sink += *cyl_map_find_int(&m, keys[order[k]]);
+    r.map_ns = (now_seconds() - t0) * 1e9 / (double)lookups;
+
+    t0 = now_seconds();
+    for (size_t k = 0; k < lookups; k++) {
+        int64_t want = keys[order[k]];
+        for (size_t j = 0; j < n; j++) {
+            if (keys[j] == want) {
+                sink += values[j];
+                break;
+            }
+        }
+    }
+    r.scan_ns = (now_seconds() - t0) * 1e9 / (double)lookups;
+
+    cyl_map_free(&m);
+    free(order);
+    free(values);
+    free(keys);
+    return r;
+}
+
+static Result bench_str(size_t n, size_t lookups, uint64_t seed) {
+    char (*names)[24] = (char (*)[24])malloc(n * sizeof(*names));
+    char (*probes)[24] = (char (*)[24])malloc(n * sizeof(*probes)); // equal bytes, different pointers
+    StrSlice *keys = (StrSlice *)malloc(n * sizeof(StrSlice));
+    size_t *order = (size_t *)malloc(lookups * sizeof(size_t));
+    CylMap m;
+    cyl_map_init(&m, CYL_MAP_STR, n);
+
+    for (size_t k = 0; k < n; k++) {
+        int inserted;
+        snprintf(names[k], sizeof(names[k]), "name_%llx", (unsigned long long)(next_rand(&seed) >> 20));
+        memcpy(probes[k], names[k], sizeof(names[k]));
+        keys[k].ptr = names[k];
+        keys[k].len = strlen(names[k]);
+        *cyl_map_upsert_str(&m, keys[k], &inserted) = k;
+    }
+    for (size_t k = 0; k < lookups; k++) order[k] = (size_t)(next_rand(&seed) % n);
+
+    Result r;
+    double t0 = now_seconds();
+    for (size_t k = 0; k < lookups; k++) {
+        StrSlice want = { probes[order[k]], keys[order[k]].len };
+        uint64_t *v = cyl_map_find_str(&m, want);
+        sink += v ? *v : 0;
+    }
+    r.map_ns = (now_seconds() - t0) * 1e9 / (double)lookups;
+
+    t0 = now_seconds();
+    for (size_t k = 0; k < lookups; k++) {
+        StrSlice want = { probes[order[k]], keys[order[k]].len };
+        for (size_t j = 0; j < n; j++) {
+            if (keys[j].len == want.len && memcmp(keys[j].ptr, want.ptr, want.len) == 0) {
+                sink += j;
+                break;
+            }
+        }
+    }
+    r.scan_ns = (now_seconds() - t0) * 1e9 / (double)lookups;
+
+    cyl_map_free(&m);
+    free(order);
+    free(keys);
+    free(probes);
+    free(names);
+    return r;
+}
+
+int main(int argc, char **argv) {
+    size_t lookups = 200000;
+    uint64_t seed = 42;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--lookups") == 0 && a + 1 < argc) {
+            lookups = (size_t)strtoull(argv[++a], NULL, 10);
+            if (!lookups) lookups = 1;
+        } else if (strcmp(argv[a], "--seed") == 0 && a + 1 < argc) {
+            seed = strtoull(argv[++a], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--lookups <n>] [--seed <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static const size_t sizes[] = { 4, 16, 64, 256, 1024, 4096 };
+    size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    printf("{\n");
+    printf("  \"benchmark\": \"map_vs_list_scan\",\n");
+    printf("  \"lookups\": %zu,\n", lookups);
+    printf("  \"results\": [\n");
+    for (size_t k = 0; k < nsizes; k++) {
+        Result ri = bench_int(sizes[k], lookups, seed);
+        Result rs = bench_str(sizes[k], lookups, seed);
+        printf("    {\"n\": %zu, \"int\": {\"map_ns\": %.1f, \"scan_ns\": %.1f}, "
+               "\"str\": {\"map_ns\": %.1f, \"scan_ns\": %.1f}}%s\n",
+               sizes[k], ri.map_ns, ri.scan_ns, rs.map_ns, rs.scan_ns, k + 1 < nsizes ? "," : "");
+    }
+    printf("  ],\n");
+    printf("  \"checksum\": %llu\n", (unsigned long long)sink);
+    printf("}\n");
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "utf8.h"
+
+/*
+    Code point counting and indexing on runtime strings, against what the
+    string builtins would do without them: decode with utf8_next from the
+    start of the string every time.
+
+    For an all-ASCII text and a mixed Sinhala/English text of the same byte
+    size, times
+      - utf8_count vs. a utf8_next loop, over the whole text
+      - `queries` random code point offsets through Utf8Index vs. a walk
+        from byte 0 (the index build is included in its time)
+    and checks that both sides agree. JSON on stdout; exit code 1 on a
+    mismatch.
+*/
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t next_rand(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+typedef struct Result {
+    size_t count;
+    double count_ns_per_byte;
+    double decode_ns_per_byte;
+    double index_ns;
+    double walk_ns;
+    int ok;
+} Result;
+
+// the checksums keep the compiler from dropping the walks
+static uint64_t sink;
+
+static size_t decode_count(const uint8_t *s, size_t len) {
+    size_t i = 0, n = 0;
+    uint32_t cp;
+    while (utf8_next(s, len, &i, &cp) == UTF8_OK) n++;
+    return n;
+}
+
+static size_t decode_offset(const uint8_t *s, size_t len, size_t cp) {
+    size_t i = 0;
+    uint32_t c;
+    for (size_t k = 0; k < cp && utf8_next(s, len, &i, &c) == UTF8_OK; k++) {}
+    return i;
+}
+
+/*
+    Words of ASCII, or of Sinhala (3 bytes per code point) with every
+    fourth word ASCII, cut at a code point boundary.
+*/
+static uint8_t *make_text(size_t size, int mixed, uint64_t seed, size_t *out_len) {
+    static const char *const ascii_words[] = { "var", "count", "while", "input", "name", "print" };
+    static const char *const sinhala_words[] = { "\xe0\xb6\xb1\xe0\xb6\xb8", "\xe0\xb6\x85\xe0\xb6\xa9\xe0\xb7\x94", "\xe0\xb6\xbd\xe0\xb6\x82\xe0\xb6\x9a\xe0\xb7\x8f" };
+    uint8_t *buf = (uint8_t *)malloc(size + 16);
+    if (!buf) return NULL;
+
+    size_t len = 0;
+    for (size_t w = 0; len < size; w++) {
+        const char *word = mixed && w % 4 != 0 ? sinhala_words[next_rand(&seed) % 3] : ascii_words[next_rand(&seed) % 6];
+        size_t n = strlen(word);
+        if (len + n + 1 > size) break;
+        memcpy(buf + len, word, n);
+        len += n;
+        buf[len++] = ' ';
+    }
+    *out_len = len;
+    return buf;
+}
+
+static int run(const uint8_t *s, size_t len, size_t queries, uint64_t seed, Result *r) {
+    memset(r, 0, sizeof(*r));
+
+    double t0 = now_seconds();
+    r->count = utf8_count(s, len);
+    r->count_ns_per_byte = (now_seconds() - t0) * 1e9 / (double)len;
+
+    t0 = now_seconds();
+    size_t decoded = decode_count(s, len);
+    r->decode_ns_per_byte = (now_seconds() - t0) * 1e9 / (double)len;
+
+    size_t *cps = (size_t *)malloc(queries * sizeof(size_t));
+    size_t *bytes = (size_t *)malloc(queries * sizeof(size_t));
+    if (!cps || !bytes) {
+        free(cps);
+        free(bytes);
+        return 0;
+    }
+    for (size_t k = 0; k < queries; k++) cps[k] = (size_t)(next_rand(&seed) % (r->count + 1));
+
+    Utf8Index ix;
+    utf8_index_init(&ix, s, len);
+    int ok = 1;
+    t0 = now_seconds();
+    for (size_t k = 0; ok && k < queries; k++) ok = utf8_index_offset(&ix, cps[k], &bytes[k]);
+    r->index_ns = (now_seconds() - t0) * 1e9 / (double)queries;
+
+    size_t ix_count = 0;
+    ok = ok && utf8_index_length(&ix, &ix_count);
+    utf8_index_free(&ix);
+
+    r->ok = ok && decoded == r->count && ix_count == r->count;
+    t0 = now_seconds();
+    for (size_t k = 0; k < queries; k++) {
+        size_t b = decode_offset(s, len, cps[k]);
+        if (b != bytes[k]) r->ok = 0;
+        sink += b;
+    }
+    r->walk_ns = (now_seconds() - t0) * 1e9 / (double)queries;
+
+    free(bytes);
+    free(cps);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    size_t size_kb = 256;
+    size_t queries = 2000;
+    uint64_t seed = 42;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--size-kb") == 0 && a + 1 < argc) {
+            size_kb = (size_t)strtoull(argv[++a], NULL, 10);
+            if (!size_kb) size_kb = 1;
+        } else if (strcmp(argv[a], "--queries") == 0 && a + 1 < argc) {
+            queries = (size_t)strtoull(argv[++a], NULL, 10);
+            if (!queries) queries = 1;
+        } else if (strcmp(argv[a], "--seed") == 0 && a + 1 < argc) {
+            seed = strtoull(argv[++a], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--size-kb <n>] [--queries <n>] [--seed <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static const char *const names[] = { "ascii", "mixed" };
+    Result r[2];
+    size_t lens[2];
+    for (int m = 0; m < 2; m++) {
+        uint8_t *text = make_text(size_kb * 1024, m, seed, &lens[m]);
+        if (!text || !run(text, lens[m], queries, seed, &r[m])) {
+            free(text);
+            fprintf(stderr, "error: out of memory\n");
+            return 1;
+        }
+        free(text);
+    }
+
+    int ok = r[0].ok && r[1].ok;
+    printf("{\n");
+    printf("  \"benchmark\": \"utf8_count_and_index\",\n");
+    printf("  \"queries\": %zu,\n", queries);
+    printf("  \"results\": [\n");
+    for (int m = 0; m < 2; m++) {
+        printf("    {\"text\": \"%s\", \"bytes\": %zu, \"code_points\": %zu, "
+               "\"count\": {\"utf8_count_ns_per_byte\": %.3f, \"decode_ns_per_byte\": %.3f}, "
+               "\"offset\": {\"index_ns\": %.1f, \"walk_ns\": %.1f}, \"ok\": %s}%s\n",
+               names[m], lens[m], r[m].count, r[m].count_ns_per_byte, r[m].decode_ns_per_byte,
+               r[m].index_ns, r[m].walk_ns, r[m].ok ? "true" : "false", m < 1 ? "," : "");
+    }
+    printf("  ],\n");
+    printf("  \"checksum\": %llu\n", (unsigned long long)sink);
+    printf("}\n");
+    if (!ok) fprintf(stderr, "error: utf8_count/Utf8Index disagree with utf8_next\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,356 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#include "corpus.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define IDENT_POOL 64
+#define MAX_DEPTH 3
+
+typedef struct Gen {
+    const CorpusOptions* opts;
+    StrBuf* out;
+    uint64_t rng;
+    int ok;
+
+    StrBuf en_idents[IDENT_POOL];
+    StrBuf si_idents[IDENT_POOL];
+} Gen;
+
+// keyword spellings: [0] English, [1] Sinhala
+typedef struct Spelling {
+    const char* var;
+    const char* if_;
+    const char* then;
+    const char* else_;
+    const char* end;
+    const char* while_;
+    const char* do_;
+    const char* for_;
+    const char* to;
+    const char* for_then;
+    const char* function;
+    const char* return_;
+    const char* write;
+} Spelling;
+
+static const Spelling SPELLINGS[2] = {
+    { "var", "if", "then", "else", "end", "while", "do",
+      "for", "to", "then", "function", "return", "write" },
+    { "විචල්‍ය", "මෙහි", "නම්", "එසේ_නැත්නම්", "අවසන්", "මෙහි", "අතරතුර",
+      "මෙහි", "සිට", "තෙක්", "ශ්‍රීතය", "දෙන්න", "ලියන්න" }
+};
+
+static const char* const WORDS[] = {
+    "Hello", "World", "value", "total", "ආයුබෝවන්", "ලෝකය", "අගය", "එකතුව", "නම", "result"
+};
+
+/* ----------------------------
+   Random numbers (splitmix64)
+   ---------------------------- */
+
+static uint64_t next_u64(Gen* g) {
+    uint64_t z = (g->rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static size_t rand_below(Gen* g, size_t n) {
+    return n ? (size_t)(next_u64(g) % n) : 0;
+}
+
+static int chance(Gen* g, double p) {
+    return (double)(next_u64(g) >> 11) * (1.0 / 9007199254740992.0) < p;
+}
+
+/* ----------------------------
+   Emitters
+   ---------------------------- */
+
+static void put(Gen* g, const char* s) {
+    if (g->ok) g->ok = strbuf_append(g->out, s, strlen(s));
+}
+
+static void put_sb(Gen* g, const StrBuf* sb) {
+    if (g->ok) g->ok = strbuf_append(g->out, sb->data, sb->len);
+}
+
+static void put_indent(Gen* g, int depth) {
+    for (int d = 0; d < depth; d++) put(g, "\t");
+}
+
+static uint32_t sinhala_consonant(Gen* g) {
+    // assigned consonants in U+0D9A..U+0DC6
+    static const uint32_t ranges[][2] = {
+        { 0x0D9A, 0x0DB1 }, { 0x0DB3, 0x0DBB }, { 0x0DBD, 0x0DBD }, { 0x0DC0, 0x0DC6 }
+    };
+    size_t pick = rand_below(g, 41); // total consonants across the ranges
+    for (size_t r = 0; r < 4; r++) {
+        size_t n = ranges[r][1] - ranges[r][0] + 1;
+        if (pick < n) return ranges[r][0] + (uint32_t)pick;
+        pick -= n;
+    }
+    return ranges[0][0];
+}
+
+static uint32_t sinhala_vowel_sign(Gen* g) {
+    static const uint32_t signs[] = { 0x0DCA, 0x0DCF, 0x0DD0, 0x0DD2, 0x0DD4, 0x0DD9, 0x0DDC };
+    return signs[rand_below(g, sizeof(signs) / sizeof(signs[0]))];
+}
+
+static int make_ident(Gen* g, StrBuf* sb, int sinhala) {
+    size_t span = g->opts->ident_max - g->opts->ident_min + 1;
+    size_t n = g->opts->ident_min + rand_below(g, span);
+    if (n == 0) n = 1;
+
+    for (size_t k = 0; k < n; k++) {
+        int ok;
+        if (sinhala) {
+            // consonant, sometimes followed by a vowel sign (both count as code points)
+            ok = strbuf_append_cp(sb, sinhala_consonant(g));
+            if (ok && k + 1 < n && chance(g, 0.4)) {
+                ok = strbuf_append_cp(sb, sinhala_vowel_sign(g));
+                k++;
+            }
+        } else {
+            static const char alpha[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+            static const char alnum[] = "abcdefghijklmnopqrstuvwxyz_0123456789";
+            char c = k == 0 ? alpha[rand_below(g, sizeof(alpha) - 1)]
+                            : alnum[rand_below(g, sizeof(alnum) - 1)];
+            ok = strbuf_append_byte(sb, c);
+        }
+        if (!ok) return 0;
+    }
+
+    // keep well clear of keywords without a lookup
+    return strbuf_append(sb, sinhala ? "_" : "_v", sinhala ? 1 : 2);
+}
+
+static void put_ident(Gen* g, int sinhala) {
+    StrBuf* pool = sinhala ? g->si_idents : g->en_idents;
+    put_sb(g, &pool[rand_below(g, IDENT_POOL)]);
+}
+
+static void put_number(Gen* g) {
+    char buf[64];
+    if (chance(g, 0.25)) {
+        snprintf(buf, sizeof(buf), "%u.%u", (unsigned)rand_below(g, 1000), (unsigned)rand_below(g, 100000));
+    } else {
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long)rand_below(g, 1000000));
+    }
+    put(g, buf);
+}
+
+static void put_string(Gen* g) {
+    put(g, "\"");
+    size_t words = 1 + rand_below(g, 5);
+    for (size_t k = 0; k < words; k++) {
+        if (k) put(g, chance(g, 0.1) ? "\\n" : " ");
+        put(g, WORDS[rand_below(g, sizeof(WORDS) / sizeof(WORDS[0]))]);
+    }
+    put(g, "\"");
+}
+
+static void put_operand(Gen* g, int sinhala) {
+    if (chance(g, g->opts->number_density)) put_number(g);
+    else put_ident(g, sinhala);
+}
+
+static void put_expr(Gen* g, int sinhala) {
+    static const char* const ops[] = { " + ", " - ", " * ", " / ", " ^ " };
+    size_t terms = 1 + rand_below(g, 4);
+    int paren = terms > 2 && chance(g, 0.3);
+
+    if (paren) put(g, "(");
+    put_operand(g, sinhala);
+    for (size_t k = 1; k < terms; k++) {
+        put(g, ops[rand_below(g, 5)]);
+        put_operand(g, sinhala);
+        if (paren && k == 1) put(g, ")");
+    }
+}
+
+static void put_cond(Gen* g, int sinhala) {
+    static const char* const cmps[] = { " < ", " > ", " <= ", " >= ", " == ", " != " };
+    put_operand(g, sinhala);
+    put(g, cmps[rand_below(g, 6)]);
+    put_operand(g, sinhala);
+}
+
+static void put_end_of_statement(Gen* g) {
+    if (chance(g, g->opts->comment_density)) {
+        put(g, " # ");
+        put(g, WORDS[rand_below(g, sizeof(WORDS) / sizeof(WORDS[0]))]);
+        put(g, " note");
+    }
+    put(g, "\n");
+}
+
+static void put_statement(Gen* g, int depth);
+
+static void put_block(Gen* g, int depth) {
+    size_t n = 1 + rand_below(g, 4);
+    for (size_t k = 0; k < n; k++) put_statement(g, depth);
+}
+
+static void put_statement(Gen* g, int depth) {
+    int si = chance(g, g->opts->sinhala_ratio);
+    const Spelling* kw = &SPELLINGS[si];
+    size_t kind = rand_below(g, 20);
+    if (depth >= MAX_DEPTH && kind >= 12) kind = 0; // only flat statements when deep
+
+    put_indent(g, depth);
+
+    if (kind < 8) {
+        put(g, kw->var); put(g, " ");
+        put_ident(g, si);
+        put(g, " = ");
+        if (chance(g, g->opts->string_density)) put_string(g);
+        else put_expr(g, si);
+        put_end_of_statement(g);
+    } else if (kind < 12) {
+        put(g, kw->write); put(g, "(");
+        if (chance(g, g->opts->string_density)) { put_string(g); put(g, ", "); }
+        put_expr(g, si);
+        put(g, ")");
+        put_end_of_statement(g);
+    } else if (kind < 15) {
+        put(g, kw->if_); put(g, " ");
+        put_cond(g, si);
+        put(g, " "); put(g, kw->then); put_end_of_statement(g);
+        put_block(g, depth + 1);
+        if (chance(g, 0.4)) {
+            put_indent(g, depth); put(g, kw->else_); put(g, "\n");
+            put_block(g, depth + 1);
+        }
+        put_indent(g, depth); put(g, kw->end); put(g, "\n");
+    } else if (kind < 17) {
+        put(g, kw->while_); put(g, " ");
+        put_cond(g, si);
+        put(g, " "); put(g, kw->do_); put_end_of_statement(g);
+        put_block(g, depth + 1);
+        put_indent(g, depth); put(g, kw->end); put(g, "\n");
+    } else if (kind < 19) {
+        put(g, kw->for_); put(g, " ");
+        put_ident(g, si);
+        put(g, "="); put_number(g);
+        put(g, " "); put(g, kw->to); put(g, " ");
+        put_operand(g, si);
+        put(g, " "); put(g, kw->for_then); put_end_of_statement(g);
+        put_block(g, depth + 1);
+        put_indent(g, depth); put(g, kw->end); put(g, "\n");
+    } else {
+        put(g, kw->function); put(g, " ");
+        put_ident(g, si);
+        put(g, "(");
+        size_t params = rand_below(g, 4);
+        for (size_t k = 0; k < params; k++) {
+            if (k) put(g, ", ");
+            put_ident(g, si);
+        }
+        put(g, ")"); put_end_of_statement(g);
+        put_block(g, depth + 1);
+        put_indent(g, depth + 1); put(g, kw->return_); put(g, " ");
+        put_expr(g, si); put(g, "\n");
+        put_indent(g, depth); put(g, kw->end); put(g, "\n");
+    }
+}
+
+/* ----------------------------
+   Public API
+   ---------------------------- */
+
+void corpus_default_options(CorpusOptions* opts) {
+    opts->seed = 42;
+    opts->target_bytes = 16u << 20;
+    opts->sinhala_ratio = 0.5;
+    opts->ident_min = 3;
+    opts->ident_max = 12;
+    opts->string_density = 0.2;
+    opts->comment_density = 0.1;
+    opts->number_density = 0.4;
+}
+
+static int parse_ratio(const char* s, double* out) {
+    char* end = NULL;
+    double v = strtod(s, &end);
+    if (!end || *end || v < 0.0 || v > 1.0) return 0;
+    *out = v;
+    return 1;
+}
+
+int corpus_parse_option(CorpusOptions* opts, int argc, char** argv, int i) {
+    const char* name = argv[i];
+    if (strncmp(name, "--", 2) != 0) return 0;
+    name += 2;
+
+    int known = strcmp(name, "seed") == 0 || strcmp(name, "size-mb") == 0 ||
+                strcmp(name, "sinhala") == 0 || strcmp(name, "ident-min") == 0 ||
+                strcmp(name, "ident-max") == 0 || strcmp(name, "strings") == 0 ||
+                strcmp(name, "comments") == 0 || strcmp(name, "numbers") == 0;
+    if (!known) return 0;
+    if (i + 1 >= argc) return -1;
+
+    const char* v = argv[i + 1];
+    if (strcmp(name, "seed") == 0) opts->seed = strtoull(v, NULL, 10);
+    else if (strcmp(name, "size-mb") == 0) opts->target_bytes = (size_t)(strtod(v, NULL) * 1024.0 * 1024.0);
+    else if (strcmp(name, "ident-min") == 0) opts->ident_min = (size_t)strtoul(v, NULL, 10);
+    else if (strcmp(name, "ident-max") == 0) opts->ident_max = (size_t)strtoul(v, NULL, 10);
+    else if (strcmp(name, "sinhala") == 0) { if (!parse_ratio(v, &opts->sinhala_ratio)) return -1; }
+    else if (strcmp(name, "strings") == 0) { if (!parse_ratio(v, &opts->string_density)) return -1; }
+    else if (strcmp(name, "comments") == 0) { if (!parse_ratio(v, &opts->comment_density)) return -1; }
+    else if (strcmp(name, "numbers") == 0) { if (!parse_ratio(v, &opts->number_density)) return -1; }
+
+    if (opts->ident_min == 0 || opts->ident_max < opts->ident_min) return -1;
+    return 2;
+}
+
+void corpus_print_options_help(FILE* out) {
+    fprintf(out,
+            "  --seed <n>        PRNG seed (default 42)\n"
+            "  --size-mb <n>     approximate corpus size in MiB (default 16)\n"
+            "  --sinhala <0..1>  share of Sinhala statements (default 0.5)\n"
+            "  --ident-min <n>   shortest identifier in code points (default 3)\n"
+            "  --ident-max <n>   longest identifier in code points (default 12)\n"
+            "  --strings <0..1>  string literal density (default 0.2)\n"
+            "  --comments <0..1> comment density (default 0.1)\n"
+            "  --numbers <0..1>  numeric literal density (default 0.4)\n");
+}
+
+int corpus_generate(const CorpusOptions* opts, StrBuf* out) {
+    Gen g;
+    memset(&g, 0, sizeof(g));
+    g.opts = opts;
+    g.out = out;
+    g.rng = opts->seed;
+    g.ok = strbuf_reserve(out, opts->target_bytes + 4096);
+
+    for (size_t k = 0; g.ok && k < IDENT_POOL; k++) {
+        strbuf_init(&g.en_idents[k]);
+        strbuf_init(&g.si_idents[k]);
+        g.ok = make_ident(&g, &g.en_idents[k], 0) && make_ident(&g, &g.si_idents[k], 1);
+    }
+
+    while (g.ok && out->len < opts->target_bytes) put_statement(&g, 0);
+
+    for (size_t k = 0; k < IDENT_POOL; k++) {
+        strbuf_free(&g.en_idents[k]);
+        strbuf_free(&g.si_idents[k]);
+    }
+    return g.ok;
+}
+
+void corpus_options_json(const CorpusOptions* opts, FILE* out) {
+    fprintf(out,
+            "{\"seed\": %llu, \"target_bytes\": %zu, \"sinhala\": %.3f, "
+            "\"ident_min\": %zu, \"ident_max\": %zu, \"strings\": %.3f, "
+            "\"comments\": %.3f, \"numbers\": %.3f}",
+            (unsigned long long)opts->seed, opts->target_bytes, opts->sinhala_ratio,
+            opts->ident_min, opts->ident_max, opts->string_density,
+            opts->comment_density, opts->number_density);
+}
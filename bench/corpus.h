@@ -0,0 +1,59 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_BENCH_CORPUS_H
+#define CEYLONICUS_BENCH_CORPUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "strbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Deterministic synthetic .cyl corpus generator.
+    Same options + seed always give byte-identical output, so benchmark
+    numbers are comparable across commits and machines.
+*/
+
+typedef struct CorpusOptions {
+    uint64_t seed;
+    size_t target_bytes;
+
+    double sinhala_ratio; // share of statements spelled with Sinhala keywords/identifiers
+    size_t ident_min; // identifier length in code points
+    size_t ident_max;
+
+    double string_density; // chance a statement carries a string literal
+    double comment_density; // chance of a comment after a statement
+    double number_density; // chance an operand is a numeric literal (vs identifier)
+} CorpusOptions;
+
+void corpus_default_options(CorpusOptions* opts);
+
+/*
+    Parse one `--name value` pair into opts.
+    Returns 2 if both argv[i] and argv[i+1] were consumed, 0 if argv[i] is not a corpus option,
+    -1 on a bad value.
+*/
+int corpus_parse_option(CorpusOptions* opts, int argc, char** argv, int i);
+
+void corpus_print_options_help(FILE* out);
+
+// returns 1 on success, 0 on out of memory
+int corpus_generate(const CorpusOptions* opts, StrBuf* out);
+
+// options as a JSON object (no trailing newline)
+void corpus_options_json(const CorpusOptions* opts, FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_BENCH_CORPUS_H
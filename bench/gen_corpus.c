@@ -0,0 +1,58 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "corpus.h"
+
+static void print_usage(const char *progname) {
+    fprintf(stderr, "Usage: %s [options] [-o <out.cyl>]\n", progname);
+    corpus_print_options_help(stderr);
+}
+
+int main(int argc, char **argv) {
+    CorpusOptions opts;
+    corpus_default_options(&opts);
+    const char *out_path = NULL;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "-o") == 0 && a + 1 < argc) {
+            out_path = argv[++a];
+            continue;
+        }
+        int used = corpus_parse_option(&opts, argc, argv, a);
+        if (used <= 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        a += used - 1;
+    }
+
+    StrBuf sb;
+    strbuf_init(&sb);
+    if (!corpus_generate(&opts, &sb)) {
+        fprintf(stderr, "error: out of memory generating corpus\n");
+        strbuf_free(&sb);
+        return 1;
+    }
+
+    FILE *f = out_path ? fopen(out_path, "wb") : stdout;
+    if (!f) {
+        fprintf(stderr, "error: could not open file: %s\n", out_path);
+        strbuf_free(&sb);
+        return 1;
+    }
+
+    int ok = fwrite(sb.data, 1, sb.len, f) == sb.len;
+    if (out_path && fclose(f) != 0) ok = 0;
+    strbuf_free(&sb);
+
+    if (!ok) {
+        fprintf(stderr, "error: failed to write corpus\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#include "arith.h"
+
+static int mul_overflows(int64_t a, int64_t b, int64_t* out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, out);
+#else
+    if (a == 0 || b == 0) { *out = 0; return 0; }
+    if (a > 0) {
+        if (b > 0) { if (a > INT64_MAX / b) return 1; }
+        else       { if (b < INT64_MIN / a) return 1; }
+    } else {
+        if (b > 0) { if (a < INT64_MIN / b) return 1; }
+        else       { if (a < INT64_MAX / b) return 1; }
+    }
+    *out = a * b;
+    return 0;
+#endif
+}
+
+ArithStatus arith_ipow(int64_t base, int64_t exp, int64_t* out) {
+    if (exp < 0) {
+        // 1 and -1 are the only bases that stay integral
+        if (base == 1) { *out = 1; return ARITH_OK; }
+        if (base == -1) { *out = (exp & 1) ? -1 : 1; return ARITH_OK; }
+        return ARITH_NEG_EXPONENT;
+    }
+
+    // cheap cases that would otherwise loop or overflow needlessly
+    if (base == 0) { *out = exp == 0 ? 1 : 0; return ARITH_OK; }
+    if (base == 1) { *out = 1; return ARITH_OK; }
+    if (base == -1) { *out = (exp & 1) ? -1 : 1; return ARITH_OK; }
+
+    int64_t result = 1;
+    int64_t b = base;
+    uint64_t e = (uint64_t)exp;
+
+    for (;;) {
+        if (e & 1u) {
+            if (mul_overflows(result, b, &result)) return ARITH_OVERFLOW;
+        }
+        e >>= 1;
+        if (!e) break;
+        // |base| >= 2 here, so more than 63 squarings always overflows
+        if (mul_overflows(b, b, &b)) return ARITH_OVERFLOW;
+    }
+
+    *out = result;
+    return ARITH_OK;
+}
+
+double arith_powi(double base, int64_t exp) {
+    int neg = exp < 0;
+    // avoid negating INT64_MIN
+    uint64_t e = neg ? (uint64_t)(-(exp + 1)) + 1u : (uint64_t)exp;
+
+    double result = 1.0;
+    double b = base;
+    while (e) {
+        if (e & 1u) result *= b;
+        e >>= 1;
+        if (e) b *= b;
+    }
+
+    return neg ? 1.0 / result : result;
+}
+
+size_t arith_pow_chain(uint64_t exp, PowStep* steps) {
+    if (exp == 0) return 0;
+
+    // left-to-right binary method: skip the leading 1 bit
+    int top = 63;
+    while (!((exp >> top) & 1u)) top--;
+
+    size_t n = 0;
+    for (int bit = top - 1; bit >= 0; bit--) {
+        steps[n++] = POW_STEP_SQUARE;
+        if ((exp >> bit) & 1u) steps[n++] = POW_STEP_MUL_BASE;
+    }
+    return n;
+}
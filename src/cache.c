@@ -0,0 +1,132 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "cache.h"
+#include "version.h"
+#include "stats.h"
+#include "tokfile.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define cache_mkdir(p) _mkdir(p)
+#else
+#include <sys/stat.h>
+#define cache_mkdir(p) mkdir((p), 0777)
+#endif
+
+/* ----------------------------
+   Helpers
+   ---------------------------- */
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t n) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t k = 0; k < n; k++) {
+        h ^= p[k];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static void entry_path(const Cache* c, uint64_t key, char* out, size_t cap) {
+    snprintf(out, cap, "%s/%016llx%s", c->dir, (unsigned long long)key, TOKFILE_EXTENSION);
+}
+
+/* ----------------------------
+   Public API
+   ---------------------------- */
+
+int cache_open(Cache* c, const char* dir) {
+    memset(c, 0, sizeof(*c));
+    c->dir = dir ? dir : CACHE_DEFAULT_DIR;
+
+    if (cache_mkdir(c->dir) != 0 && errno != EEXIST) {
+        fprintf(stderr, "warning: cannot create cache directory: %s\n", c->dir);
+        return 0;
+    }
+    return 1;
+}
+
+void cache_clone(Cache* dst, const Cache* src) {
+    memset(dst, 0, sizeof(*dst));
+    dst->dir = src->dir;
+    dst->verify = src->verify;
+}
+
+void cache_merge_stats(Cache* dst, const Cache* src) {
+    dst->stats.hits += src->stats.hits;
+    dst->stats.misses += src->stats.misses;
+    dst->stats.stores += src->stats.stores;
+    dst->stats.store_failures += src->stats.store_failures;
+}
+
+uint64_t cache_key(const uint8_t* src, size_t len, const char* flags) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    h = fnv1a(h, CEYLONICUS_VERSION, sizeof(CEYLONICUS_VERSION));
+    if (flags) h = fnv1a(h, flags, strlen(flags) + 1);
+    h = fnv1a(h, &len, sizeof(len));
+    return fnv1a(h, src, len);
+}
+
+int cache_load_tokens(Cache* c, uint64_t key, const uint8_t* src, size_t len, TokenBuffer* tb) {
+    (void)src;
+
+    char path[4096];
+    entry_path(c, key, path, sizeof(path));
+
+    TokFileView view;
+    if (!tokfile_map(path, &view)) {
+        c->stats.misses++;
+        return 0;
+    }
+
+    int ok = view.header->src_hash == key && view.header->src_len == (uint64_t)len &&
+             view.count > 0 && (!c->verify || tokfile_verify(&view)) && tokfile_to_buffer(&view, tb);
+    tokfile_unmap(&view);
+
+    if (ok) c->stats.hits++;
+    else c->stats.misses++;
+    return ok;
+}
+
+int cache_store_tokens(Cache* c, uint64_t key, const uint8_t* src, size_t len, const TokenBuffer* tb) {
+    (void)src;
+
+    char path[4096];
+    entry_path(c, key, path, sizeof(path));
+
+    StrBuf image;
+    strbuf_init(&image);
+    int ok = tokfile_build(tb, key, len, &image);
+
+    if (ok && !write_file_atomic(path, image.data, image.len)) {
+        // if another process beat us to it the entry is identical
+        FILE* probe = fopen(path, "rb");
+        ok = probe != NULL;
+        if (probe) fclose(probe);
+    }
+    strbuf_free(&image);
+
+    if (ok) c->stats.stores++;
+    else c->stats.store_failures++;
+    return ok;
+}
+
+void cache_print_stats(const Cache* c, FILE* out) {
+    size_t lookups = c->stats.hits + c->stats.misses;
+    fprintf(out, "cache: %s\n", c->dir);
+    fprintf(out, "  hits:   %zu\n", c->stats.hits);
+    fprintf(out, "  misses: %zu\n", c->stats.misses);
+    fprintf(out, "  stores: %zu", c->stats.stores);
+    if (c->stats.store_failures) fprintf(out, " (%zu failed)", c->stats.store_failures);
+    fprintf(out, "\n");
+    if (lookups) {
+        fprintf(out, "  hit rate: %.1f%%\n", 100.0 * (double)c->stats.hits / (double)lookups);
+    }
+}
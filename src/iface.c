@@ -0,0 +1,184 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "iface.h"
+#include "mapfile.h"
+#include "strbuf.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const FUNCTION_KEYWORDS[] = { "function", "ශ්‍රීතය", "කාර්යය", NULL };
+static const char* const IMPORT_KEYWORDS[] = { "import", "ආනයනය", NULL };
+
+static int slice_in(StrSlice s, const char* const* list) {
+    for (size_t k = 0; list[k]; k++) {
+        size_t n = strlen(list[k]);
+        if (s.len == n && memcmp(s.ptr, list[k], n) == 0) return 1;
+    }
+    return 0;
+}
+
+int iface_is_function_keyword(StrSlice s) {
+    return slice_in(s, FUNCTION_KEYWORDS);
+}
+
+int iface_is_import_keyword(StrSlice s) {
+    return slice_in(s, IMPORT_KEYWORDS);
+}
+
+/* ----------------------------
+   Extraction
+   ---------------------------- */
+
+static int push_func(Iface* f, size_t* cap, IfaceFunc fn) {
+    if (f->func_count == *cap) {
+        size_t nc = *cap ? *cap * 2 : 16;
+        IfaceFunc* n = (IfaceFunc*)realloc(f->funcs, nc * sizeof(IfaceFunc));
+        if (!n) return 0;
+        f->funcs = n;
+        *cap = nc;
+    }
+    f->funcs[f->func_count++] = fn;
+    return 1;
+}
+
+static int push_import(Iface* f, size_t* cap, StrSlice name) {
+    if (f->import_count == *cap) {
+        size_t nc = *cap ? *cap * 2 : 8;
+        StrSlice* n = (StrSlice*)realloc(f->imports, nc * sizeof(StrSlice));
+        if (!n) return 0;
+        f->imports = n;
+        *cap = nc;
+    }
+    f->imports[f->import_count++] = name;
+    return 1;
+}
+
+int iface_extract(const TokenBuffer* tb, Iface* out) {
+    memset(out, 0, sizeof(*out));
+    size_t func_cap = 0, import_cap = 0;
+    const Token* t = tb->items;
+    size_t n = tb->count;
+
+    for (size_t k = 0; k + 1 < n; k++) {
+        if (t[k].type != TOK_KEYWORD) continue;
+
+        if (iface_is_import_keyword(t[k].value.str)) {
+            if (t[k + 1].type == TOK_ID && !push_import(out, &import_cap, t[k + 1].value.str)) goto oom;
+            continue;
+        }
+
+        // function NAME ( [ID {, ID}] )
+        if (!iface_is_function_keyword(t[k].value.str)) continue;
+        if (k + 2 >= n || t[k + 1].type != TOK_ID || t[k + 2].type != TOK_LPAREN) continue;
+
+        IfaceFunc fn;
+        fn.name = t[k + 1].value.str;
+        fn.arity = 0;
+        fn.ret_type = IFACE_TYPE_ANY;
+
+        size_t j = k + 3;
+        while (j < n && t[j].type != TOK_RPAREN) {
+            if (t[j].type == TOK_ID) fn.arity++;
+            else if (t[j].type != TOK_COMMA) break;
+            j++;
+        }
+        if (j >= n || t[j].type != TOK_RPAREN) continue; // malformed, the parser will complain
+
+        if (!push_func(out, &func_cap, fn)) goto oom;
+        k = j;
+    }
+    return 1;
+
+oom:
+    iface_free(out);
+    return 0;
+}
+
+void iface_free(Iface* iface) {
+    free(iface->funcs);
+    free(iface->imports);
+    memset(iface, 0, sizeof(*iface));
+}
+
+/* ----------------------------
+   Serialization
+   ---------------------------- */
+
+static int serialize(const Iface* iface, StrBuf* out) {
+    IfaceHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = IFACE_MAGIC;
+    h.version = IFACE_VERSION;
+    h.func_count = (uint32_t)iface->func_count;
+    h.import_count = (uint32_t)iface->import_count;
+
+    size_t strings_len = 0;
+    for (size_t k = 0; k < iface->func_count; k++) strings_len += iface->funcs[k].name.len;
+    for (size_t k = 0; k < iface->import_count; k++) strings_len += iface->imports[k].len;
+    if (strings_len > UINT32_MAX) return 0;
+    h.strings_len = (uint32_t)strings_len;
+
+    if (!strbuf_append(out, (const char*)&h, sizeof(h))) return 0;
+
+    uint32_t off = 0;
+    for (size_t k = 0; k < iface->func_count; k++) {
+        IfaceFuncRec r;
+        r.name_off = off;
+        r.name_len = (uint32_t)iface->funcs[k].name.len;
+        r.arity = iface->funcs[k].arity;
+        r.ret_type = iface->funcs[k].ret_type;
+        off += r.name_len;
+        if (!strbuf_append(out, (const char*)&r, sizeof(r))) return 0;
+    }
+    for (size_t k = 0; k < iface->import_count; k++) {
+        IfaceImportRec r;
+        r.name_off = off;
+        r.name_len = (uint32_t)iface->imports[k].len;
+        off += r.name_len;
+        if (!strbuf_append(out, (const char*)&r, sizeof(r))) return 0;
+    }
+
+    for (size_t k = 0; k < iface->func_count; k++) {
+        if (!strbuf_append(out, iface->funcs[k].name.ptr, iface->funcs[k].name.len)) return 0;
+    }
+    for (size_t k = 0; k < iface->import_count; k++) {
+        if (!strbuf_append(out, iface->imports[k].ptr, iface->imports[k].len)) return 0;
+    }
+    return 1;
+}
+
+static int same_as_existing(const char* path, const char* data, size_t len) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+
+    char* old = (char*)malloc(len + 1);
+    size_t got = old ? fread(old, 1, len + 1, f) : 0;
+    fclose(f);
+
+    int same = old && got == len && memcmp(old, data, len) == 0;
+    free(old);
+    return same;
+}
+
+int iface_write_if_changed(const char* path, const Iface* iface) {
+    StrBuf bytes;
+    strbuf_init(&bytes);
+    if (!serialize(iface, &bytes)) {
+        strbuf_free(&bytes);
+        return -1;
+    }
+
+    int result = 0;
+    if (!same_as_existing(path, bytes.data, bytes.len)) {
+        result = write_file_atomic(path, bytes.data, bytes.len) ? 1 : -1;
+    }
+    strbuf_free(&bytes);
+    return result;
+}
@@ -0,0 +1,62 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_ARITH_H
+#define CEYLONICUS_ARITH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Helpers for lowering TOK_POWER (`a ^ b`).
+    Used by constant folding and by the backends so integer powers never go
+    through libm pow().
+*/
+
+typedef enum ArithStatus {
+    ARITH_OK = 0,
+    ARITH_OVERFLOW, // result does not fit in int64
+    ARITH_NEG_EXPONENT // int ^ negative int: not an integer, use arith_powi
+} ArithStatus;
+
+/*
+    int ^ int by exponentiation by squaring with overflow detection.
+    On ARITH_OK *out holds the result; otherwise *out is untouched.
+*/
+ArithStatus arith_ipow(int64_t base, int64_t exp, int64_t* out);
+
+// float ^ int (same semantics as llvm.powi), negative exponents allowed
+double arith_powi(double base, int64_t exp);
+
+/*
+    Multiply chain for a small constant exponent, computed at compile time.
+    Starting from acc = x, apply the steps in order:
+        POW_STEP_SQUARE   acc = acc * acc
+        POW_STEP_MUL_BASE acc = acc * x
+    e.g. x^5 -> SQUARE, SQUARE, MUL_BASE  (x^2, x^4, x^5)
+*/
+typedef enum PowStep {
+    POW_STEP_SQUARE,
+    POW_STEP_MUL_BASE
+} PowStep;
+
+// exponents up to this are worth expanding inline (at most 2*log2 multiplies)
+#define ARITH_POW_EXPAND_MAX 32
+
+/*
+    Fills steps (room for 2*64 entries is always enough) for exp >= 1.
+    Returns the number of steps, 0 for exp == 1 (the result is x itself).
+*/
+size_t arith_pow_chain(uint64_t exp, PowStep* steps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_ARITH_H
@@ -0,0 +1,75 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_CACHE_H
+#define CEYLONICUS_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "lexer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    On-disk compilation cache.
+    Entries live in a flat directory and are named after a hash of
+    (compiler version, flags, source bytes), so an unchanged file can skip
+    lexing (and later parsing/codegen) entirely.
+
+    Entries are written to a private temp file and rename()d into place, so
+    parallel builds sharing one cache directory never observe a half-written
+    entry; a reader that loses the race just sees a miss.
+*/
+
+#define CACHE_DEFAULT_DIR ".cylcache"
+
+typedef struct CacheStats {
+    size_t hits;
+    size_t misses;
+    size_t stores;
+    size_t store_failures;
+} CacheStats;
+
+/*
+    A Cache handle is not shared between threads: parallel drivers give every
+    worker its own handle on the same directory and merge the stats at the end.
+*/
+typedef struct Cache {
+    const char* dir;
+    CacheStats stats;
+    int verify; // checksum entries on load (--verify); otherwise header and bounds only
+} Cache;
+
+// creates dir if needed; returns 1 on success, 0 if the cache is unusable
+int cache_open(Cache* c, const char* dir);
+
+// another handle on the same directory, for one worker
+void cache_clone(Cache* dst, const Cache* src);
+
+void cache_merge_stats(Cache* dst, const Cache* src);
+
+uint64_t cache_key(const uint8_t* src, size_t len, const char* flags);
+
+/*
+    Load the token stream for key (stored as a .cyltok image).
+    Every payload is placed in tb->string_arena.
+    Returns 1 on hit, 0 on miss (including stale or corrupt entries).
+*/
+int cache_load_tokens(Cache* c, uint64_t key, const uint8_t* src, size_t len, TokenBuffer* tb);
+
+// returns 1 if the entry was written (or already present)
+int cache_store_tokens(Cache* c, uint64_t key, const uint8_t* src, size_t len, const TokenBuffer* tb);
+
+void cache_print_stats(const Cache* c, FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_CACHE_H
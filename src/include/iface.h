@@ -0,0 +1,102 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_IFACE_H
+#define CEYLONICUS_IFACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lexer.h"
+#include "token.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Module interface files (.cyli).
+    A compact binary summary of what a module exports (function names, arities,
+    inferred types) plus what it imports. It holds nothing about the source
+    bytes themselves, so the file changes only when the exports do and
+    mtime-driven builds skip dependents after an export-preserving edit.
+
+    Layout (native endian, 4-byte aligned):
+        IfaceHeader
+        IfaceFuncRec   [func_count]
+        IfaceImportRec [import_count]
+        char           strings[strings_len]   (UTF-8 names, not terminated)
+*/
+
+#define IFACE_MAGIC 0x494C5943u // "CYLI"
+#define IFACE_VERSION 2u
+#define IFACE_EXTENSION ".cyli"
+
+typedef enum IfaceType {
+    IFACE_TYPE_ANY = 0 // not inferred (yet)
+} IfaceType;
+
+typedef struct IfaceHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t func_count;
+    uint32_t import_count;
+    uint32_t strings_len;
+    uint32_t reserved;
+} IfaceHeader;
+
+typedef struct IfaceFuncRec {
+    uint32_t name_off;
+    uint32_t name_len;
+    uint32_t arity;
+    uint32_t ret_type; // IfaceType
+} IfaceFuncRec;
+
+typedef struct IfaceImportRec {
+    uint32_t name_off;
+    uint32_t name_len;
+} IfaceImportRec;
+
+/*
+    In-memory interface built from a token stream.
+    Names are slices into the token buffer's source, so the TokenBuffer
+    (and source) must outlive it.
+*/
+typedef struct IfaceFunc {
+    StrSlice name;
+    uint32_t arity;
+    uint32_t ret_type;
+} IfaceFunc;
+
+typedef struct Iface {
+    IfaceFunc* funcs;
+    size_t func_count;
+    StrSlice* imports;
+    size_t import_count;
+} Iface;
+
+// keyword helpers shared with the driver
+int iface_is_function_keyword(StrSlice s);
+int iface_is_import_keyword(StrSlice s);
+
+/*
+    Collect `function name(a, b)` definitions and `import name` statements.
+    Returns 1 on success, 0 on out of memory.
+*/
+int iface_extract(const TokenBuffer* tb, Iface* out);
+void iface_free(Iface* iface);
+
+/*
+    Serialize to path (temp file + rename). A byte-identical file is left
+    untouched, mtime included.
+    Returns 1 if written (the exports changed), 0 if unchanged, -1 on error.
+*/
+int iface_write_if_changed(const char* path, const Iface* iface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_IFACE_H
@@ -0,0 +1,76 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_INPUT_H
+#define CEYLONICUS_INPUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mapfile.h"
+#include "token.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Bulk reader behind the input builtins.
+    A regular file on the descriptor (`prog < data.txt`) is mapped whole;
+    pipes and terminals are read through a large buffer. Lines come back as
+    views into that memory, with no copy. Mapped views stay valid until
+    input_close. Buffered views are only valid until the next read.
+    Numbers are parsed in place with the lexer's literal rules (numparse),
+    plus an optional leading '-'.
+*/
+
+#define INPUT_BUFFER_SIZE (1u << 20)
+
+typedef struct InputReader {
+    int fd;
+    MappedFile map;
+    uint8_t* buf; // buffered mode
+    size_t cap;
+    const uint8_t* data; // current window: map.data or buf
+    size_t len;
+    size_t pos;
+    int eof; // no more bytes beyond data[len)
+} InputReader;
+
+// returns 0 on out of memory
+int input_open_fd(InputReader* in, int fd);
+void input_close(InputReader* in);
+
+// next line without its "\n" / "\r\n"; returns 0 at end of input
+int input_read_line(InputReader* in, StrSlice* out);
+
+/*
+    Skip whitespace (newlines included) and read one number.
+    Returns 1 on success, 0 at end of input, and -1 if the next word is not
+    a number (for ints: also when it is outside the int64 range). On -1 the
+    word is consumed, so a loop that skips bad words cannot get stuck, and
+    *out is untouched.
+*/
+int input_read_int(InputReader* in, int64_t* out);
+int input_read_float(InputReader* in, double* out);
+
+/* ----------------------------
+   Builtin names
+   ---------------------------- */
+
+typedef enum InputBuiltin {
+    INPUT_BUILTIN_LINE, // input / ආදානය, read_line / පේළිය_කියවන්න
+    INPUT_BUILTIN_INT, // read_int / පූර්ණ_සංඛ්‍යාව_කියවන්න
+    INPUT_BUILTIN_FLOAT // read_float / දශම_සංඛ්‍යාව_කියවන්න
+} InputBuiltin;
+
+// map a call's identifier to its builtin; returns 0 if it is not one
+int input_builtin_lookup(StrSlice name, InputBuiltin* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_INPUT_H
@@ -27,6 +27,15 @@ typedef enum LexerStatus {
 
 typedef int (*LexerIsKeywordFn)(StrSlice s);
 
+// one recorded problem (error-recovery mode)
+typedef struct LexerDiag {
+    LexerStatus status;
+    Position start;
+    Position end;
+    uint32_t cp; // offending codepoint when relevant
+    char expected_ascii;
+} LexerDiag;
+
 typedef struct Lexer {
     const uint8_t* src;
     size_t len;
@@ -50,6 +59,14 @@ typedef struct Lexer {
     uint32_t error_cp; //offending codepoint when relevant
     char expected_ascii; // '=' after '!' for != (0 if not used)
 
+    // error recovery (off unless lexer_set_recovery is called)
+    int recover;
+    size_t max_errors; // record at most this many diagnostics
+    LexerDiag* diags;
+    size_t diag_count;
+    size_t diag_cap;
+    int error_cap_hit; // lexing stopped at an error past max_errors
+
 } Lexer;
 
 // Initialize a lexer over a UTF-8 byte buffer
@@ -58,14 +75,57 @@ void lexer_init(Lexer* lx, const char* filename, const uint8_t* src, size_t len)
 // set/replace keyword matcher (optional)
 void lexer_set_keyword_fn(Lexer* lx, LexerIsKeywordFn fn);
 
+/*
+    Enable error recovery: instead of stopping, each lexical error is recorded
+    in lx->diags, a TOK_ERROR token covering the bad span is returned with
+    LEX_OK, and lexing resumes at the next safe point (newline, quote or valid
+    UTF-8 lead byte). Invalid UTF-8 inside a string literal becomes U+FFFD.
+    Once max_errors diagnostics are recorded, the next error ends lexing: it
+    is not recorded, error_cap_hit is set and its status is returned as in
+    normal mode. max_errors == 0 means no cap.
+*/
+void lexer_set_recovery(Lexer* lx, size_t max_errors);
+
+// releases the diagnostics buffer (the lexer owns nothing else)
+void lexer_free(Lexer* lx);
+
 /*
 Get next token.
     - on LEX_OK; out_tok is valid
     - on LEX_EOF: out_tok will typically be TOK_EOF (implementation choice)
     - on error: out_tok is unspecified; check lx->error_* fields for details.
+      (in recovery mode errors come back as TOK_ERROR tokens, see above)
 */
 LexerStatus lexer_next_token(Lexer* lx, Token* out_tok);
 
+/*
+    Growable array of tokens for a whole file.
+    TOK_STRING payloads are heap-owned: either one allocation per token
+    (string_arena == NULL, as produced by lexer_next_token) or all payloads,
+    identifiers included, inside string_arena (e.g. when loaded from a
+    .cyltok image or the compilation cache).
+*/
+typedef struct TokenBuffer {
+    Token* items;
+    size_t count;
+    size_t cap;
+    char* string_arena; // optional, owns every payload when set
+} TokenBuffer;
+
+void token_buffer_init(TokenBuffer* tb);
+
+// returns 1 on success, 0 on out of memory
+int token_buffer_push(TokenBuffer* tb, const Token* tok);
+
+// frees the tokens and any string payloads they own
+void token_buffer_free(TokenBuffer* tb);
+
+/*
+    Lex the rest of the input into tb, including the trailing TOK_EOF.
+    Returns LEX_EOF on success; on error the tokens lexed so far are kept in tb.
+*/
+LexerStatus lexer_tokenize(Lexer* lx, TokenBuffer* tb);
+
 #ifdef __cplusplus
 }
 #endif
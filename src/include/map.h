@@ -0,0 +1,81 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_MAP_H
+#define CEYLONICUS_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "token.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Open-addressing hash map (SwissTable layout), the backing store for the
+    language's map type (`map` / `සිතියම`, literals `{k: v, ...}`).
+
+    Slots are split into groups of CYL_MAP_GROUP. Each slot has a one-byte
+    control entry: empty, deleted, or the low 7 bits of its key's hash. A
+    lookup loads a whole group of control bytes, compares all of them against
+    the wanted 7 bits at once (SSE2 when available) and only looks at the
+    keys whose bytes match; a group with an empty entry ends the probe.
+
+    Keys are either all int64 or all strings, fixed at init, so each kind
+    gets its own hash and compare. String keys are not copied: they must
+    outlive the map (interned strings and source slices do). Identical
+    pointers short-circuit the compare. Values are opaque 64-bit words.
+*/
+
+#define CYL_MAP_GROUP 16
+
+typedef enum CylMapKeyKind {
+    CYL_MAP_INT,
+    CYL_MAP_STR
+} CylMapKeyKind;
+
+typedef struct CylMapSlot {
+    union {
+        int64_t i;
+        StrSlice s;
+    } key;
+    uint64_t value;
+} CylMapSlot;
+
+typedef struct CylMap {
+    int8_t* ctrl; // cap control bytes
+    CylMapSlot* slots; // cap slots
+    size_t cap; // 0 or a power of two >= CYL_MAP_GROUP
+    size_t count;
+    size_t tombstones;
+    CylMapKeyKind kind;
+} CylMap;
+
+// expected = number of keys to size for up front (0 = allocate lazily); returns 0 on out of memory
+int cyl_map_init(CylMap* m, CylMapKeyKind kind, size_t expected);
+void cyl_map_free(CylMap* m);
+
+// pointer to the value, or NULL when absent; valid until the next insert
+uint64_t* cyl_map_find_int(const CylMap* m, int64_t key);
+uint64_t* cyl_map_find_str(const CylMap* m, StrSlice key);
+
+/*
+    Find or insert. *inserted tells which; a new entry's value is 0.
+    Returns NULL only on out of memory.
+*/
+uint64_t* cyl_map_upsert_int(CylMap* m, int64_t key, int* inserted);
+uint64_t* cyl_map_upsert_str(CylMap* m, StrSlice key, int* inserted);
+
+// returns 1 if the key was present
+int cyl_map_remove_int(CylMap* m, int64_t key);
+int cyl_map_remove_str(CylMap* m, StrSlice key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_MAP_H
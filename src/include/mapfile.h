@@ -0,0 +1,45 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_MAPFILE_H
+#define CEYLONICUS_MAPFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Read-only whole-file mapping.
+    Uses mmap where available so loading is a page fault, not a copy;
+    on Windows it falls back to reading the file into the heap.
+*/
+typedef struct MappedFile {
+    const uint8_t* data;
+    size_t size;
+    int mapped; // 1 = mmap, 0 = heap copy
+} MappedFile;
+
+// returns 1 on success, 0 if the file is missing, empty or unreadable
+int map_file(const char* path, MappedFile* out);
+void unmap_file(MappedFile* mf);
+
+// map an already open descriptor (not closed) if it is a non-empty regular file; 0 otherwise, and always on Windows
+int map_fd(int fd, MappedFile* out);
+
+/*
+    Write data to a temp file next to path (pid + per-process counter), then
+    rename it into place, so readers mapping path never see a partial file.
+    Returns 1 on success, 0 on error (the temp file is removed).
+*/
+int write_file_atomic(const char* path, const void* data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_MAPFILE_H
@@ -0,0 +1,40 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_NUMPARSE_H
+#define CEYLONICUS_NUMPARSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Allocation-free parsing of Ceylonicus number literals, shared by the
+    lexer and the runtime's input builtins.
+    A literal is ASCII digits with at most one '.', e.g. 42, 3.5, .5, 7.
+    (a lone "." is not a number). No sign: the lexer makes '-' an operator;
+    readers handle the sign themselves.
+*/
+
+// length of the literal at the start of s (0 if none); *is_float set when it has a '.'
+size_t num_scan(const uint8_t* s, size_t len, int* is_float);
+
+// digits only; returns 0 if the value does not fit in uint64
+int num_parse_u64(const char* s, size_t n, uint64_t* out);
+
+// digits only; saturates at INT64_MAX like strtoll
+int64_t num_parse_int(const char* s, size_t n);
+
+// a literal as returned by num_scan; correctly rounded (same result as strtod)
+double num_parse_float(const char* s, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_NUMPARSE_H
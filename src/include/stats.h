@@ -0,0 +1,108 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_STATS_H
+#define CEYLONICUS_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "token.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Compiler instrumentation: per-phase wall time plus a few counters.
+    Build with -DCEYLONICUS_STATS to enable; without it every STATS_* macro
+    expands to nothing, so release builds carry no cost at all.
+
+    Counters are collected into whatever Stats the current thread points
+    stats_current at (one per worker), and merged at the end.
+*/
+
+typedef enum StatsPhase {
+    STATS_PHASE_READ,
+    STATS_PHASE_CACHE,
+    STATS_PHASE_LEX,
+    STATS_PHASE_MODULES,
+    STATS_PHASE_FORMAT,
+    STATS_PHASE_EMIT,
+    STATS_PHASE_COUNT
+} StatsPhase;
+
+#define STATS_TOKEN_TYPES 64
+
+typedef struct Stats {
+    uint64_t phase_ns[STATS_PHASE_COUNT];
+    uint64_t phase_calls[STATS_PHASE_COUNT];
+
+    uint64_t files;
+    uint64_t bytes_read;
+    uint64_t bytes_decoded;
+    uint64_t tokens[STATS_TOKEN_TYPES];
+    uint64_t ifaces_written; // --emit-interface: exports changed, dependents need rebuilding
+    uint64_t ifaces_unchanged;
+
+    uint64_t allocs;
+    uint64_t alloc_bytes;
+    uint64_t token_buffer_peak; // high-water mark of a token buffer, in bytes
+} Stats;
+
+typedef const char* (*StatsTokenNameFn)(TokenType type);
+
+uint64_t stats_now_ns(void);
+void stats_merge(Stats* dst, const Stats* src);
+
+// phases only (--time-report) or phases and counters (--stats)
+void stats_print_table(FILE* out, const Stats* s, uint64_t wall_ns, int counters, StatsTokenNameFn name);
+void stats_print_json(FILE* out, const Stats* s, uint64_t wall_ns, int counters, StatsTokenNameFn name);
+
+#ifdef CEYLONICUS_STATS
+
+#if defined(_MSC_VER)
+#define STATS_THREAD_LOCAL __declspec(thread)
+#else
+#define STATS_THREAD_LOCAL _Thread_local
+#endif
+
+extern STATS_THREAD_LOCAL Stats* stats_current;
+
+#define STATS_ENABLED 1
+#define STATS_BIND(s) (stats_current = (s))
+#define STATS_TIMER_BEGIN(name) uint64_t stats_t0_##name = stats_now_ns()
+#define STATS_TIMER_END(name, phase) do { \
+        if (stats_current) { \
+            stats_current->phase_ns[phase] += stats_now_ns() - stats_t0_##name; \
+            stats_current->phase_calls[phase]++; \
+        } \
+    } while (0)
+#define STATS_ADD(field, n) do { if (stats_current) stats_current->field += (uint64_t)(n); } while (0)
+#define STATS_MAX(field, v) do { \
+        if (stats_current && (uint64_t)(v) > stats_current->field) stats_current->field = (uint64_t)(v); \
+    } while (0)
+#define STATS_ALLOC(bytes) do { \
+        if (stats_current) { stats_current->allocs++; stats_current->alloc_bytes += (uint64_t)(bytes); } \
+    } while (0)
+
+#else
+
+#define STATS_ENABLED 0
+#define STATS_BIND(s) ((void)0)
+#define STATS_TIMER_BEGIN(name) ((void)0)
+#define STATS_TIMER_END(name, phase) ((void)0)
+#define STATS_ADD(field, n) ((void)0)
+#define STATS_MAX(field, v) ((void)0)
+#define STATS_ALLOC(bytes) ((void)0)
+
+#endif // CEYLONICUS_STATS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_STATS_H
@@ -0,0 +1,56 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_STRBUF_H
+#define CEYLONICUS_STRBUF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Growable, uniquely owned UTF-8 byte buffer.
+    Appends are amortized O(1) (capacity doubles), so building a string out of
+    many small pieces is linear instead of the quadratic copy-per-concat you get
+    with immutable strings. This is what `x += "..."` inside a loop should lower
+    to once the runtime knows `x` is not shared.
+*/
+typedef struct StrBuf {
+    char* data; // NULL until the first append, always '\0'-terminated after it
+    size_t len; // bytes used (not counting the terminator)
+    size_t cap; // bytes allocated
+} StrBuf;
+
+void strbuf_init(StrBuf* sb);
+
+// make room for at least `extra` more bytes (+1 for the terminator)
+// returns 1 on success, 0 on out of memory
+int strbuf_reserve(StrBuf* sb, size_t extra);
+
+int strbuf_append(StrBuf* sb, const char* s, size_t n);
+int strbuf_append_byte(StrBuf* sb, char c);
+
+// printf-style append
+int strbuf_appendf(StrBuf* sb, const char* fmt, ...);
+
+// encode a Unicode scalar value as UTF-8 and append it
+int strbuf_append_cp(StrBuf* sb, uint32_t cp);
+
+/*
+    Hand the bytes over to the caller (heap-owned, null-terminated, trimmed to size).
+    The buffer is reset to empty afterwards. Returns NULL on out of memory.
+*/
+char* strbuf_detach(StrBuf* sb, size_t* out_len);
+
+void strbuf_free(StrBuf* sb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_STRBUF_H
@@ -0,0 +1,48 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_THREADPOOL_H
+#define CEYLONICUS_THREADPOOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Work-stealing thread pool.
+    Every worker owns a deque: it pushes/pops its own tasks at the bottom (LIFO,
+    cache friendly) and idle workers steal from the top of somebody else's
+    deque (FIFO, takes the oldest and usually largest piece of work).
+    Tasks may submit further tasks; they land on the submitting worker's deque.
+*/
+
+typedef void (*ThreadPoolTaskFn)(void* arg, unsigned worker);
+
+typedef struct ThreadPool ThreadPool;
+
+// number of online cores (at least 1)
+unsigned thread_pool_default_threads(void);
+
+// returns NULL on failure
+ThreadPool* thread_pool_create(unsigned nthreads);
+
+unsigned thread_pool_size(const ThreadPool* pool);
+
+// returns 1 on success, 0 on out of memory
+int thread_pool_submit(ThreadPool* pool, ThreadPoolTaskFn fn, void* arg);
+
+// block until every submitted task (including ones they spawned) has finished
+void thread_pool_wait(ThreadPool* pool);
+
+// waits for outstanding work, then joins the workers
+void thread_pool_destroy(ThreadPool* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_THREADPOOL_H
@@ -48,6 +48,10 @@ typedef enum {
     TOK_RSQUARE,
     TOK_PLUSEQ,
     TOK_MINUSEQ,
+    TOK_LBRACE, // map literals: {key: value, ...}
+    TOK_RBRACE,
+    TOK_COLON,
+    TOK_ERROR, // placeholder for a skipped bad span (error-recovery mode only)
 } TokenType;
 
 typedef struct {
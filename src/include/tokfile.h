@@ -0,0 +1,119 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_TOKFILE_H
+#define CEYLONICUS_TOKFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lexer.h"
+#include "mapfile.h"
+#include "strbuf.h"
+#include "token.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Binary token stream (.cyltok).
+    Struct-of-arrays layout with no pointers, so an image is written with a
+    single write and used straight out of an mmap. Identifier, keyword and
+    string payloads live in an interned string table; the value column holds
+    the table index for those, the integer, or the double's bits.
+
+    Layout (native endian):
+        TokFileHeader
+        sections[TOKFILE_SEC_COUNT], each 8-byte aligned, at header->sections[k]
+
+    The image length is always a multiple of 8. checksum covers the whole
+    image, header included (with the checksum field taken as 0). Loading
+    only validates the header and section bounds; the checksum is checked on
+    request (tokfile_verify, --verify), so mapping stays O(1) in its size.
+*/
+
+#define TOKFILE_MAGIC 0x544C5943u // "CYLT"
+#define TOKFILE_VERSION 3u
+#define TOKFILE_EXTENSION ".cyltok"
+
+typedef enum TokFileSection {
+    TOKFILE_SEC_TYPE, // uint8_t   [token_count]
+    TOKFILE_SEC_START_INDEX, // uint32_t  [token_count]
+    TOKFILE_SEC_START_LINE, // uint32_t  [token_count]
+    TOKFILE_SEC_START_COL, // uint32_t  [token_count]
+    TOKFILE_SEC_END_INDEX, // uint32_t  [token_count]
+    TOKFILE_SEC_END_LINE, // uint32_t  [token_count]
+    TOKFILE_SEC_END_COL, // uint32_t  [token_count]
+    TOKFILE_SEC_VALUE, // uint64_t  [token_count]
+    TOKFILE_SEC_STR_OFF, // uint32_t  [string_count]
+    TOKFILE_SEC_STR_LEN, // uint32_t  [string_count]
+    TOKFILE_SEC_STR_DATA, // char      [strings_len]
+    TOKFILE_SEC_COUNT
+} TokFileSection;
+
+typedef struct TokFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t src_hash; // producer-defined source identity (0 = unknown)
+    uint64_t src_len;
+    uint64_t token_count;
+    uint64_t string_count;
+    uint64_t strings_len;
+    uint64_t image_len; // whole file, header included
+    uint64_t checksum; // of the whole image, this field as 0
+    uint64_t sections[TOKFILE_SEC_COUNT];
+} TokFileHeader;
+
+/*
+    Serialize tb into one contiguous image in out.
+    Positions are stored as 32-bit, so sources must be < 4 GiB.
+    Returns 1 on success, 0 on out of memory or oversized input.
+*/
+int tokfile_build(const TokenBuffer* tb, uint64_t src_hash, size_t src_len, StrBuf* out);
+
+// write an image with a single write (temp file + rename); returns 1 on success
+int tokfile_write(const char* path, const StrBuf* image);
+
+typedef struct TokFileView {
+    MappedFile file;
+    const TokFileHeader* header;
+    size_t count;
+
+    const uint8_t* type;
+    const uint32_t* start_index;
+    const uint32_t* start_line;
+    const uint32_t* start_col;
+    const uint32_t* end_index;
+    const uint32_t* end_line;
+    const uint32_t* end_col;
+    const uint64_t* value;
+
+    const uint32_t* str_off;
+    const uint32_t* str_len;
+    const char* str_data;
+} TokFileView;
+
+// map and validate the layout; returns 0 if missing, truncated or a different version
+int tokfile_map(const char* path, TokFileView* out);
+void tokfile_unmap(TokFileView* view);
+
+// full-content check against header->checksum (reads every page); returns 1 if intact
+int tokfile_verify(const TokFileView* view);
+
+// materialize token i; string payloads point into the mapping (no copy)
+void tokfile_get(const TokFileView* view, size_t i, Token* out);
+
+/*
+    Copy the whole stream into tb (AoS) so it outlives the mapping;
+    payloads go into tb->string_arena. Returns 1 on success.
+*/
+int tokfile_to_buffer(const TokFileView* view, TokenBuffer* tb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CEYLONICUS_TOKFILE_H
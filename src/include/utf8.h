@@ -25,9 +25,55 @@ typedef enum {
     - out_cp receives the decoded Unicode code point (scalar value)
     Returns UTF8_OK, UTF8_EOF, or UTF8_INVALID.
 */
-
 Utf8Status utf8_next(const uint8_t* buf, size_t len, size_t* i, uint32_t* out_cp);
 
+/*
+    Writes the UTF-8 encoding of cp into out (room for 4 bytes is required).
+    Returns the number of bytes written (1..4).
+*/
+size_t utf8_encode(uint32_t cp, uint8_t* out);
+
+/*
+    Number of code points in valid UTF-8 (counts every byte that is not a
+    10xxxxxx continuation byte), 16 bytes per step with SSE2.
+*/
+size_t utf8_count(const uint8_t* buf, size_t len);
+
+// 1 if every byte is < 0x80
+int utf8_is_ascii(const uint8_t* buf, size_t len);
+
+/*
+    Code point index over a UTF-8 string (runtime strings are always valid:
+    the lexer replaces bad bytes with U+FFFD).
+    Nothing is computed until the first query. That query checks for
+    all-ASCII (offsets are then the indices themselves) or else counts the
+    string once and records the byte offset of every UTF8_CRUMB_STRIDE-th
+    code point. After that, length is O(1), and offset/slice jump to the
+    nearest breadcrumb and walk fewer than UTF8_CRUMB_STRIDE code points.
+*/
+#define UTF8_CRUMB_STRIDE 64
+
+typedef struct Utf8Index {
+    const uint8_t* data;
+    size_t len;
+    size_t count; // code points, once built
+    size_t* crumbs; // crumbs[k] = byte offset of code point k * UTF8_CRUMB_STRIDE
+    int built;
+    int ascii;
+} Utf8Index;
+
+void utf8_index_init(Utf8Index* ix, const uint8_t* data, size_t len);
+void utf8_index_free(Utf8Index* ix);
+
+// the queries build the index on first use; they return 0 on out of memory or an out-of-range index
+int utf8_index_length(Utf8Index* ix, size_t* out_count);
+
+// byte offset of code point cp (cp == length gives len)
+int utf8_index_offset(Utf8Index* ix, size_t cp, size_t* out_byte);
+
+// code points [from, to) as a byte range
+int utf8_index_slice(Utf8Index* ix, size_t from, size_t to, size_t* out_byte, size_t* out_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,12 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#ifndef CEYLONICUS_VERSION_H
+#define CEYLONICUS_VERSION_H
+
+// bump whenever lexer/compiler output changes so on-disk caches are invalidated
+#define CEYLONICUS_VERSION "0.1.0"
+
+#endif // CEYLONICUS_VERSION_H
@@ -0,0 +1,210 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "input.h"
+#include "numparse.h"
+#include "stats.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static long read_some(int fd, uint8_t* p, size_t n) {
+#ifdef _WIN32
+    return (long)_read(fd, p, (unsigned)(n > 0x40000000u ? 0x40000000u : n));
+#else
+    return (long)read(fd, p, n);
+#endif
+}
+
+int input_open_fd(InputReader* in, int fd) {
+    memset(in, 0, sizeof(*in));
+    in->fd = fd;
+
+    if (map_fd(fd, &in->map)) {
+        in->data = in->map.data;
+        in->len = in->map.size;
+#ifndef _WIN32
+        // honour whatever the shell or a previous reader already consumed
+        off_t at = lseek(fd, 0, SEEK_CUR);
+        if (at > 0) in->pos = (size_t)at < in->len ? (size_t)at : in->len;
+#endif
+        in->eof = 1;
+        return 1;
+    }
+
+    in->cap = INPUT_BUFFER_SIZE;
+    in->buf = (uint8_t*)malloc(in->cap);
+    if (!in->buf) return 0;
+    STATS_ALLOC(in->cap);
+    in->data = in->buf;
+    return 1;
+}
+
+void input_close(InputReader* in) {
+    unmap_file(&in->map);
+    free(in->buf);
+    memset(in, 0, sizeof(*in));
+}
+
+/*
+    Buffered mode only: move the unread tail to the front and read more
+    after it. The buffer doubles when a single line or word fills it.
+    Returns 1 if bytes were added; pos is 0 afterwards either way.
+*/
+static int refill(InputReader* in) {
+    if (in->eof) return 0;
+
+    size_t keep = in->len - in->pos;
+    if (in->pos) memmove(in->buf, in->buf + in->pos, keep);
+    in->pos = 0;
+    in->len = keep;
+
+    if (in->len == in->cap) {
+        uint8_t* nb = (uint8_t*)realloc(in->buf, in->cap * 2);
+        if (!nb) return 0;
+        STATS_ALLOC(in->cap);
+        in->buf = nb;
+        in->cap *= 2;
+        in->data = nb;
+    }
+
+    for (;;) {
+        long got = read_some(in->fd, in->buf + in->len, in->cap - in->len);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) {
+            in->eof = 1;
+            return 0;
+        }
+        in->len += (size_t)got;
+        return 1;
+    }
+}
+
+static StrSlice make_line(const uint8_t* p, size_t n) {
+    if (n && p[n - 1] == '\r') n--;
+    StrSlice s = { (const char*)p, n };
+    return s;
+}
+
+int input_read_line(InputReader* in, StrSlice* out) {
+    size_t scanned = 0; // bytes after pos already known to hold no '\n'
+    for (;;) {
+        const uint8_t* from = in->data + in->pos + scanned;
+        const uint8_t* nl = (const uint8_t*)memchr(from, '\n', in->len - in->pos - scanned);
+        if (nl) {
+            size_t end = (size_t)(nl - in->data);
+            *out = make_line(in->data + in->pos, end - in->pos);
+            in->pos = end + 1;
+            return 1;
+        }
+        scanned = in->len - in->pos;
+        if (!refill(in)) break;
+    }
+
+    if (in->pos >= in->len) return 0;
+
+    // last line without a newline
+    *out = make_line(in->data + in->pos, in->len - in->pos);
+    in->pos = in->len;
+    return 1;
+}
+
+static int is_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// next whitespace-delimited word, contiguous in the window
+static int next_word(InputReader* in, const uint8_t** word, size_t* n) {
+    for (;;) {
+        while (in->pos < in->len && is_space(in->data[in->pos])) in->pos++;
+        if (in->pos < in->len) break;
+        if (!refill(in)) return 0;
+    }
+
+    size_t len = 0;
+    for (;;) {
+        const uint8_t* p = in->data + in->pos;
+        size_t avail = in->len - in->pos;
+        while (len < avail && !is_space(p[len])) len++;
+        if (len < avail || !refill(in)) break;
+    }
+
+    *word = in->data + in->pos;
+    *n = len;
+    in->pos += len;
+    return 1;
+}
+
+int input_read_int(InputReader* in, int64_t* out) {
+    const uint8_t* w;
+    size_t n;
+    if (!next_word(in, &w, &n)) return 0;
+
+    int neg = w[0] == '-';
+    int is_float = 0;
+    size_t used = num_scan(w + neg, n - (size_t)neg, &is_float);
+    if (!used || used != n - (size_t)neg || is_float) return -1;
+
+    // magnitude first: -9223372036854775808 is in range, its positive is not
+    uint64_t mag;
+    if (!num_parse_u64((const char*)w + neg, used, &mag)) return -1;
+    if (mag > (uint64_t)INT64_MAX + (uint64_t)neg) return -1;
+    *out = neg ? (int64_t)(0 - mag) : (int64_t)mag;
+    return 1;
+}
+
+int input_read_float(InputReader* in, double* out) {
+    const uint8_t* w;
+    size_t n;
+    if (!next_word(in, &w, &n)) return 0;
+
+    int neg = w[0] == '-';
+    int is_float = 0;
+    size_t used = num_scan(w + neg, n - (size_t)neg, &is_float);
+    if (!used || used != n - (size_t)neg) return -1;
+
+    double v = num_parse_float((const char*)w + neg, used);
+    *out = neg ? -v : v;
+    return 1;
+}
+
+/* ----------------------------
+   Builtin names
+   ---------------------------- */
+
+typedef struct BuiltinName {
+    const char* name;
+    InputBuiltin builtin;
+} BuiltinName;
+
+static const BuiltinName builtin_names[] = {
+    { "input", INPUT_BUILTIN_LINE },
+    { "read_line", INPUT_BUILTIN_LINE },
+    { "read_int", INPUT_BUILTIN_INT },
+    { "read_float", INPUT_BUILTIN_FLOAT },
+    { "ආදානය", INPUT_BUILTIN_LINE },
+    { "පේළිය_කියවන්න", INPUT_BUILTIN_LINE },
+    { "පූර්ණ_සංඛ්‍යාව_කියවන්න", INPUT_BUILTIN_INT },
+    { "දශම_සංඛ්‍යාව_කියවන්න", INPUT_BUILTIN_FLOAT },
+};
+
+int input_builtin_lookup(StrSlice name, InputBuiltin* out) {
+    for (size_t k = 0; k < sizeof(builtin_names) / sizeof(builtin_names[0]); k++) {
+        const char* n = builtin_names[k].name;
+        if (strlen(n) == name.len && memcmp(n, name.ptr, name.len) == 0) {
+            *out = builtin_names[k].builtin;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -7,14 +7,14 @@
 #include "keywords.h"
 
 // Simply got from the github.com/RezSat/Ceylonicus/tokens.py 
-static const char* CEY_KEYWORDS[] = {
+static const char* const CEY_KEYWORDS[] = {
   "var","and","or","not","if","elseif","else","for","to","step","while",
-  "function","then","end","return","continue","break","do",
+  "function","then","end","return","continue","break","do","import",
   "විචල්ය","විචල්‍ය","සහ","හෝ","නොමැත","නොව","නැත","නොවේ","නොවන",
   "ශ්‍රීතය","කාර්යය","නම්","නැත්නම්","නැතිනම්","මෙහි",
   "එසේ_නැත්නම්","එසේ_නැතිනම්","එසේත්_නැත්නම්","එසේත්_නැතිනම්",
   "අවසන්","දක්වා","පියවර","තෙක්","සිට","අතර","අතරතුර",
-  "නවත්වන්න","දෙන්න","දිගටම","කරන්න",
+  "නවත්වන්න","දෙන්න","දිගටම","කරන්න","ආනයනය",
   NULL
 };
 
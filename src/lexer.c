@@ -3,6 +3,9 @@
 */
 
 #include "lexer.h"
+#include "strbuf.h"
+#include "numparse.h"
+#include "stats.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -115,6 +118,82 @@ static LexerStatus advance_cp(Lexer* lx, uint32_t* out_cp) {
     return LEX_OK;
 }
 
+/* ----------------------------
+   Error recovery
+   ---------------------------- */
+
+/*
+    Returns 0 when lexing has to stop: this error would go past the cap
+    (it is not recorded, error_cap_hit is set) or out of memory.
+*/
+static int record_diag(Lexer* lx, LexerStatus status, const Position* start, const Position* end,
+                       uint32_t cp, char expected_ascii) {
+    if (lx->max_errors && lx->diag_count >= lx->max_errors) {
+        lx->error_cap_hit = 1;
+        return 0;
+    }
+    if (lx->diag_count == lx->diag_cap) {
+        size_t cap = lx->diag_cap ? lx->diag_cap * 2 : 16;
+        LexerDiag* nd = (LexerDiag*)realloc(lx->diags, cap * sizeof(LexerDiag));
+        if (!nd) return 0;
+        lx->diags = nd;
+        lx->diag_cap = cap;
+    }
+
+    LexerDiag* d = &lx->diags[lx->diag_count++];
+    d->status = status;
+    d->start = *start;
+    d->end = *end;
+    d->cp = cp;
+    d->expected_ascii = expected_ascii;
+    return 1;
+}
+
+// room for one more diagnostic under the cap?
+static int can_recover(const Lexer* lx) {
+    return lx->recover && (!lx->max_errors || lx->diag_count < lx->max_errors);
+}
+
+/*
+    Skip a malformed UTF-8 sequence: at least one byte, then on to the next
+    byte that starts a valid sequence. The whole run counts as one column.
+*/
+static void skip_invalid_utf8(Lexer* lx) {
+    size_t i = lx->i + 1;
+    while (i < lx->len) {
+        size_t tmp = i;
+        uint32_t cp = 0;
+        if (utf8_next(lx->src, lx->len, &tmp, &cp) == UTF8_OK) break;
+        i++;
+    }
+
+    lx->has_current = 0;
+    lx->i = i;
+    lx->pos.index = i;
+    lx->pos.column += 1;
+}
+
+// unterminated string: rewind to just after the opening quote and give up at the end of that line
+static void resync_after_string(Lexer* lx, const Position* quote) {
+    lx->has_current = 0;
+    lx->i = quote->index;
+    lx->pos = *quote;
+
+    uint32_t cp = 0;
+    if (advance_cp(lx, &cp) != LEX_OK) return;
+
+    for (;;) {
+        LexerStatus st = peek_cp(lx, &cp);
+        if (st == LEX_EOF) return;
+        if (st == LEX_INVALID_UTF8) {
+            skip_invalid_utf8(lx);
+            continue;
+        }
+        if (cp == (uint32_t)'\n') return;
+        advance_cp(lx, &cp);
+    }
+}
+
 /* ----------------------------
    Token builders
    ---------------------------- */
@@ -142,10 +221,19 @@ static LexerStatus skip_comment(Lexer* lx) {
     LexerStatus st = advance_cp(lx, &cp);
     if (st != LEX_OK) return st;
 
+    int reported = 0;
     for (;;) {
         uint32_t p = 0;
         st = peek_cp(lx, &p);
         if (st == LEX_EOF) return LEX_OK;
+        if (st == LEX_INVALID_UTF8 && (reported || can_recover(lx))) {
+            // still a comment: one diagnostic for the first bad run, then on to the newline
+            Position bad = lx->pos;
+            skip_invalid_utf8(lx);
+            if (!reported && !record_diag(lx, st, &bad, &lx->pos, 0, 0)) return st;
+            reported = 1;
+            continue;
+        }
         if (st != LEX_OK) return st;
 
         if (p == (uint32_t)'\n') return LEX_OK; // stop before newline
@@ -157,64 +245,36 @@ static LexerStatus skip_comment(Lexer* lx) {
 
 static LexerStatus lex_number(Lexer* lx, Token* out) {
     Position start = lx->pos;
-    size_t start_byte = lx->i;
+    const char* text = (const char*)lx->src + lx->i;
 
-    int dot_count = 0;
-
-    for (;;) {
-        uint32_t cp = 0;
-        LexerStatus st = peek_cp(lx, &cp);
-        if (st != LEX_OK) break;
-
-        if (cp == (uint32_t)'.') {
-            if (dot_count == 1) break;
-            dot_count++;
-            uint32_t consumed = 0;
-            st = advance_cp(lx, &consumed);
-            if (st != LEX_OK) return st;
-            continue;
-        }
-
-        if (!is_ascii_digit(cp)) break;
-
-        uint32_t consumed = 0;
-        st = advance_cp(lx, &consumed);
-        if (st != LEX_OK) return st;
-    }
-
-    size_t end_byte = lx->i;
-    size_t n = end_byte - start_byte;
+    int is_float = 0;
+    size_t n = num_scan(lx->src + lx->i, lx->len - lx->i, &is_float);
 
     // Reject lone "." (otherwise strtod would accept it weirdly / fail)
     // NOTE: Treats . as a number start only if the next char is a digit, otherwise illegal
     // revist this rule if grows member access, ranges or method syntax
-    if (n == 1 && lx->src[start_byte] == (uint8_t)'.') {
+    if (n == 0) {
+        uint32_t consumed = 0;
+        advance_cp(lx, &consumed);
         Position end = lx->pos;
         set_error(lx, &start, &end, (uint32_t)'.', 0);
         return LEX_ILLEGAL_CHAR;
     }
 
-    char* tmp = (char*)malloc(n + 1);
-    if (!tmp) {
-        // treat as illegal for now (TODO: add OUT_OF_MEMORY later)
-        Position end = lx->pos;
-        set_error(lx, &start, &end, 0, 0);
-        return LEX_ILLEGAL_CHAR;
-    }
-    memcpy(tmp, (const char*)lx->src + start_byte, n);
-    tmp[n] = '\0';
-
+    // digits and '.' are ASCII: one column per byte
+    lx->has_current = 0;
+    lx->i += n;
+    lx->pos.index = lx->i;
+    lx->pos.column += n;
     Position end = lx->pos;
 
-    if (dot_count == 0) {
+    if (!is_float) {
         token_init(out, TOK_INT, &start, &end);
-        out->value.i = strtoll(tmp, NULL, 10);
+        out->value.i = num_parse_int(text, n);
     } else {
         token_init(out, TOK_FLOAT, &start, &end);
-        out->value.f = strtod(tmp, NULL);
+        out->value.f = num_parse_float(text, n);
     }
-
-    free(tmp);
     return LEX_OK;
 }
 
@@ -257,14 +317,8 @@ static LexerStatus lex_string(Lexer* lx, Token* out) {
     if (st != LEX_OK) return st;
 
     // Build unescaped string in a growable buffer
-    size_t cap = 32;
-    size_t len = 0;
-    char* buf = (char*)malloc(cap);
-    if (!buf) {
-        Position end = lx->pos;
-        set_error(lx, &start, &end, 0, 0);
-        return LEX_ILLEGAL_CHAR;
-    }
+    StrBuf sb;
+    strbuf_init(&sb);
 
     int escaping = 0;
 
@@ -275,11 +329,22 @@ static LexerStatus lex_string(Lexer* lx, Token* out) {
         if (st == LEX_EOF) {
             Position end = lx->pos;
             set_error(lx, &start, &end, 0, 0);
-            free(buf);
+            strbuf_free(&sb);
             return LEX_UNTERMINATED_STRING;
         }
+        if (st == LEX_INVALID_UTF8 && can_recover(lx)) {
+            // keep the literal, mark the damage
+            Position bad = lx->pos;
+            skip_invalid_utf8(lx);
+            if (!record_diag(lx, st, &bad, &lx->pos, 0, 0) || !strbuf_append_cp(&sb, 0xFFFDu)) {
+                strbuf_free(&sb);
+                return st;
+            }
+            escaping = 0;
+            continue;
+        }
         if (st != LEX_OK) {
-            free(buf);
+            strbuf_free(&sb);
             return st;
         }
 
@@ -287,14 +352,14 @@ static LexerStatus lex_string(Lexer* lx, Token* out) {
             // consume closing quote
             uint32_t consumed = 0;
             st = advance_cp(lx, &consumed);
-            if (st != LEX_OK) { free(buf); return st; }
+            if (st != LEX_OK) { strbuf_free(&sb); return st; }
             break;
         }
 
         // consume cp
         uint32_t consumed = 0;
         st = advance_cp(lx, &consumed);
-        if (st != LEX_OK) { free(buf); return st; }
+        if (st != LEX_OK) { strbuf_free(&sb); return st; }
 
         if (!escaping && consumed == (uint32_t)'\\') {
             escaping = 1;
@@ -312,49 +377,23 @@ static LexerStatus lex_string(Lexer* lx, Token* out) {
         // Store as UTF-8 bytes. For now: only special escapes become ASCII,
         // and otherwise we keep original codepoints by re-encoding minimal UTF-8.
         // Since consumed is a Unicode scalar value (from utf8_next), we can encode it.
-
-        // Ensure capacity for up to 4 bytes
-        if (len + 4 >= cap) {
-            cap *= 2;
-            char* nb = (char*)realloc(buf, cap);
-            if (!nb) {
-                Position end = lx->pos;
-                set_error(lx, &start, &end, 0, 0);
-                free(buf);
-                return LEX_ILLEGAL_CHAR;
-            }
-            buf = nb;
-        }
-
-        if (out_ch <= 0x7F) {
-            buf[len++] = (char)out_ch;
-        } else if (out_ch <= 0x7FF) {
-            buf[len++] = (char)(0xC0 | ((out_ch >> 6) & 0x1F));
-            buf[len++] = (char)(0x80 | (out_ch & 0x3F));
-        } else if (out_ch <= 0xFFFF) {
-            buf[len++] = (char)(0xE0 | ((out_ch >> 12) & 0x0F));
-            buf[len++] = (char)(0x80 | ((out_ch >> 6) & 0x3F));
-            buf[len++] = (char)(0x80 | (out_ch & 0x3F));
-        } else {
-            buf[len++] = (char)(0xF0 | ((out_ch >> 18) & 0x07));
-            buf[len++] = (char)(0x80 | ((out_ch >> 12) & 0x3F));
-            buf[len++] = (char)(0x80 | ((out_ch >> 6) & 0x3F));
-            buf[len++] = (char)(0x80 | (out_ch & 0x3F));
-        }
-    }
-
-    // Null-terminate for convenience (not counted in slice.len)
-    if (len + 1 >= cap) {
-        char* nb = (char*)realloc(buf, len + 1);
-        if (!nb) {
+        if (!strbuf_append_cp(&sb, out_ch)) {
             Position end = lx->pos;
             set_error(lx, &start, &end, 0, 0);
-            free(buf);
+            strbuf_free(&sb);
             return LEX_ILLEGAL_CHAR;
         }
-        buf = nb;
     }
-    buf[len] = '\0';
+
+    // Null-terminated for convenience (not counted in slice.len)
+    size_t len = 0;
+    char* buf = strbuf_detach(&sb, &len);
+    if (!buf) {
+        Position end = lx->pos;
+        set_error(lx, &start, &end, 0, 0);
+        strbuf_free(&sb);
+        return LEX_ILLEGAL_CHAR;
+    }
 
     Position end = lx->pos;
     token_init(out, TOK_STRING, &start, &end);
@@ -394,8 +433,21 @@ void lexer_set_keyword_fn(Lexer* lx, LexerIsKeywordFn fn) {
     if (lx) lx->is_keyword = fn;
 }
 
-LexerStatus lexer_next_token(Lexer* lx, Token* out_tok) {
-    if (!lx || !out_tok) return LEX_ILLEGAL_CHAR;
+void lexer_set_recovery(Lexer* lx, size_t max_errors) {
+    if (!lx) return;
+    lx->recover = 1;
+    lx->max_errors = max_errors;
+}
+
+void lexer_free(Lexer* lx) {
+    if (!lx) return;
+    free(lx->diags);
+    lx->diags = NULL;
+    lx->diag_count = 0;
+    lx->diag_cap = 0;
+}
+
+static LexerStatus lex_token(Lexer* lx, Token* out_tok) {
 
     // Clear previous error info
     lx->error_pos_start = lx->pos;
@@ -535,6 +587,9 @@ LexerStatus lexer_next_token(Lexer* lx, Token* out_tok) {
             case '[': return make_simple_token(lx, out_tok, TOK_LSQUARE);
             case ']': return make_simple_token(lx, out_tok, TOK_RSQUARE);
             case ',': return make_simple_token(lx, out_tok, TOK_COMMA);
+            case '{': return make_simple_token(lx, out_tok, TOK_LBRACE);
+            case '}': return make_simple_token(lx, out_tok, TOK_RBRACE);
+            case ':': return make_simple_token(lx, out_tok, TOK_COLON);
             
             case '!': {
                 // must be !=
@@ -643,4 +698,103 @@ LexerStatus lexer_next_token(Lexer* lx, Token* out_tok) {
         }
 
     }
-}
\ No newline at end of file
+}
+
+LexerStatus lexer_next_token(Lexer* lx, Token* out_tok) {
+    if (!lx || !out_tok) return LEX_ILLEGAL_CHAR;
+
+    size_t start_i = lx->i;
+    size_t diags_before = lx->diag_count;
+    LexerStatus st = lex_token(lx, out_tok);
+    if (!lx->recover || st == LEX_OK || st == LEX_EOF) return st;
+
+    Position start = lx->error_pos_start;
+    uint32_t cp = lx->error_cp;
+    char expected = lx->expected_ascii;
+
+    switch (st) {
+        case LEX_INVALID_UTF8:
+            start = lx->pos; // the bad byte itself
+            skip_invalid_utf8(lx);
+            break;
+        case LEX_UNTERMINATED_STRING:
+            // the rest of the line is re-lexed, so drop what the string body reported
+            lx->diag_count = diags_before;
+            resync_after_string(lx, &start);
+            break;
+        default:
+            // illegal char / expected char: the offender is already consumed
+            if (lx->i == start_i) {
+                uint32_t skipped = 0;
+                if (advance_cp(lx, &skipped) != LEX_OK) skip_invalid_utf8(lx);
+            }
+            break;
+    }
+
+    Position end = lx->pos;
+    int keep_going = record_diag(lx, st, &start, &end, cp, expected);
+
+    set_error(lx, &start, &end, cp, expected);
+    token_init(out_tok, TOK_ERROR, &start, &end);
+    out_tok->value.i = (int64_t)cp;
+
+    return keep_going ? LEX_OK : st;
+}
+
+/* ----------------------------
+   Token buffer
+   ---------------------------- */
+
+void token_buffer_init(TokenBuffer* tb) {
+    tb->items = NULL;
+    tb->count = 0;
+    tb->cap = 0;
+    tb->string_arena = NULL;
+}
+
+int token_buffer_push(TokenBuffer* tb, const Token* tok) {
+    if (tb->count == tb->cap) {
+        size_t cap = tb->cap ? tb->cap * 2 : 256;
+        Token* nt = (Token*)realloc(tb->items, cap * sizeof(Token));
+        if (!nt) return 0;
+        STATS_ALLOC(cap * sizeof(Token));
+        STATS_MAX(token_buffer_peak, cap * sizeof(Token));
+        tb->items = nt;
+        tb->cap = cap;
+    }
+    tb->items[tb->count++] = *tok;
+    return 1;
+}
+
+void token_buffer_free(TokenBuffer* tb) {
+    if (tb->string_arena) {
+        free(tb->string_arena);
+    } else {
+        for (size_t k = 0; k < tb->count; k++) {
+            if (tb->items[k].type == TOK_STRING && tb->items[k].value.str.ptr) {
+                free((void*)tb->items[k].value.str.ptr);
+            }
+        }
+    }
+    free(tb->items);
+    token_buffer_init(tb);
+}
+
+LexerStatus lexer_tokenize(Lexer* lx, TokenBuffer* tb) {
+    Token tok;
+    LexerStatus st;
+
+    while ((st = lexer_next_token(lx, &tok)) == LEX_OK) {
+        if (!token_buffer_push(tb, &tok)) {
+            if (tok.type == TOK_STRING) free((void*)tok.value.str.ptr);
+            set_error(lx, &tok.start, &tok.end, 0, 0);
+            return LEX_ILLEGAL_CHAR;
+        }
+    }
+
+    if (st == LEX_EOF && !token_buffer_push(tb, &tok)) {
+        set_error(lx, &tok.start, &tok.end, 0, 0);
+        return LEX_ILLEGAL_CHAR;
+    }
+    return st;
+}
@@ -2,17 +2,72 @@
     Author: RezSat <yehanwasura@duck.com>
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 
+#include <dirent.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+// no symlinks for the directory walk to guard against
+#define lstat stat
+#ifndef S_ISLNK
+#define S_ISLNK(m) 0
+#endif
+#endif
+
 #include "lexer.h"
 #include "keywords.h"
 #include "token.h"
+#include "cache.h"
+#include "strbuf.h"
+#include "threadpool.h"
+#include "iface.h"
+#include "stats.h"
+#include "tokfile.h"
+
+typedef struct Options {
+    int dump_tokens;
+    int use_cache;
+    int cache_stats;
+    int emit_iface;
+    int emit_tokens;
+    int verify; // checksum .cyltok images on load
+    int time_report; // 1 = table, 2 = JSON
+    int stats; // 1 = table, 2 = JSON
+    const char *cache_dir;
+    unsigned jobs; // 0 = one per core
+    size_t max_errors; // lexer diagnostics per file before giving up, 0 = no cap
+} Options;
+
+#define DEFAULT_MAX_ERRORS 20
+
+/*
+    One input file. Workers fill in out/err and result; the serial step in
+    main() prints them in input order so output never interleaves.
+*/
+typedef struct CompileJob {
+    const char *filename;
+    const Options *opts;
+    Cache *caches; // one handle per worker, NULL when caching is off
+    Stats *stats; // one per worker, NULL when not reporting
+    int result;
+    StrBuf out;
+    StrBuf err;
+} CompileJob;
+
+typedef struct FileList {
+    char **items;
+    size_t count;
+    size_t cap;
+} FileList;
 
 static void print_usage(const char *progname) {
-    fprintf(stderr, "Usage: %s [--tokens] <file.cyl>\n", progname);
+    fprintf(stderr, "Usage: %s [--tokens] [-j <n>] [--max-errors <n>] [--cache] [--cache-dir <dir>] [--cache-stats] [--emit-interface] [--emit-tokens] [--verify] [--time-report[=json]] [--stats[=json]] <file.cyl|file.cyltok|dir>...\n", progname);
 }
 
 static const char *token_type_to_str(TokenType type) {
@@ -42,28 +97,32 @@ static const char *token_type_to_str(TokenType type) {
         case TOK_ARROW:       return "ARROW";
         case TOK_PLUSEQ:      return "PLUSEQ";
         case TOK_MINUSEQ:     return "MINUSEQ";
+        case TOK_LBRACE:      return "LBRACE";
+        case TOK_RBRACE:      return "RBRACE";
+        case TOK_COLON:       return "COLON";
+        case TOK_ERROR:       return "ERROR";
         case TOK_NEWLINE:     return "NEWLINE";
         case TOK_EOF:         return "EOF";
         default:              return "UNKNOWN";
     }
 }
 
-static int read_entire_file(const char *filename, uint8_t **out_buffer, size_t *out_size) {
+static int read_entire_file(const char *filename, uint8_t **out_buffer, size_t *out_size, StrBuf *err) {
     FILE *f = fopen(filename, "rb");
     if (!f) {
-        fprintf(stderr, "error: could not open file: %s\n", filename);
+        strbuf_appendf(err, "error: could not open file: %s\n", filename);
         return 0;
     }
 
     if (fseek(f, 0, SEEK_END) != 0) {
-        fprintf(stderr, "error: failed to seek file: %s\n", filename);
+        strbuf_appendf(err, "error: failed to seek file: %s\n", filename);
         fclose(f);
         return 0;
     }
 
     long file_size = ftell(f);
     if (file_size < 0) {
-        fprintf(stderr, "error: failed to get file size: %s\n", filename);
+        strbuf_appendf(err, "error: failed to get file size: %s\n", filename);
         fclose(f);
         return 0;
     }
@@ -72,7 +131,7 @@ static int read_entire_file(const char *filename, uint8_t **out_buffer, size_t *
 
     uint8_t *buffer = (uint8_t *)malloc((size_t)file_size + 1);
     if (!buffer) {
-        fprintf(stderr, "error: out of memory while reading: %s\n", filename);
+        strbuf_appendf(err, "error: out of memory while reading: %s\n", filename);
         fclose(f);
         return 0;
     }
@@ -81,7 +140,7 @@ static int read_entire_file(const char *filename, uint8_t **out_buffer, size_t *
     fclose(f);
 
     if (bytes_read != (size_t)file_size) {
-        fprintf(stderr, "error: failed to read file fully: %s\n", filename);
+        strbuf_appendf(err, "error: failed to read file fully: %s\n", filename);
         free(buffer);
         return 0;
     }
@@ -93,99 +152,642 @@ static int read_entire_file(const char *filename, uint8_t **out_buffer, size_t *
     return 1;
 }
 
-static void print_lexer_error(const Lexer *lx, LexerStatus status) {
-    fprintf(stderr, "%s:%zu:%zu: lexer error: ",
-            lx->filename ? lx->filename : "<input>",
-            lx->error_pos_start.line + 1,
-            lx->error_pos_start.column + 1);
+static void format_lexer_error(StrBuf *err, const char *filename, const LexerDiag *d) {
+    strbuf_appendf(err, "%s:%zu:%zu: lexer error: ",
+                   filename ? filename : "<input>",
+                   d->start.line + 1,
+                   d->start.column + 1);
 
-    switch (status) {
+    switch (d->status) {
         case LEX_INVALID_UTF8:
-            fprintf(stderr, "invalid UTF-8 sequence\n");
+            strbuf_appendf(err, "invalid UTF-8 sequence\n");
             break;
         case LEX_ILLEGAL_CHAR:
-            fprintf(stderr, "illegal character (U+%04X)\n", lx->error_cp);
+            strbuf_appendf(err, "illegal character (U+%04X)\n", d->cp);
             break;
         case LEX_UNTERMINATED_STRING:
-            fprintf(stderr, "unterminated string literal\n");
+            strbuf_appendf(err, "unterminated string literal\n");
             break;
         case LEX_EXPECTED_CHAR:
-            fprintf(stderr, "expected '%c'\n", lx->expected_ascii);
+            strbuf_appendf(err, "expected '%c'\n", d->expected_ascii);
             break;
         default:
-            fprintf(stderr, "unknown lexer error (%d)\n", status);
+            strbuf_appendf(err, "unknown lexer error (%d)\n", d->status);
             break;
     }
 }
 
-static int run_lexer(const char *filename, const uint8_t *buffer, size_t size, int dump_tokens) {
+static void lexer_start(Lexer *lx, const char *filename, const uint8_t *buffer, size_t size,
+                        const Options *opts) {
+    lexer_init(lx, filename, buffer, size);
+    lexer_set_keyword_fn(lx, lexer_default_is_keyword);
+    lexer_set_recovery(lx, opts->max_errors);
+}
+
+static int lexer_failed(const Lexer *lx, LexerStatus status) {
+    return status != LEX_EOF || lx->diag_count > 0;
+}
+
+// every diagnostic collected in recovery mode, or the single hard stop
+static void report_lexer_errors(StrBuf *err, const Lexer *lx, LexerStatus status) {
+    for (size_t k = 0; k < lx->diag_count; k++) {
+        format_lexer_error(err, lx->filename, &lx->diags[k]);
+    }
+
+    if (status == LEX_EOF) return;
+    if (lx->diag_count == 0) {
+        LexerDiag d = { status, lx->error_pos_start, lx->error_pos_end, lx->error_cp, lx->expected_ascii };
+        format_lexer_error(err, lx->filename, &d);
+    } else if (lx->error_cap_hit) {
+        strbuf_appendf(err, "%s: too many lexer errors, stopping\n", lx->filename ? lx->filename : "<input>");
+    }
+}
+
+/*
+    Token dump without printf: each line is formatted straight into the job's
+    output buffer (one reserve per token), which is written out in one go.
+*/
+static char *put_u64(char *p, uint64_t v) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n) *p++ = digits[--n];
+    return p;
+}
+
+static void dump_token(StrBuf *out, const Token *tok) {
+    const char *name = token_type_to_str(tok->type);
+    size_t name_len = strlen(name);
+    int has_str = tok->type == TOK_ID || tok->type == TOK_KEYWORD || tok->type == TOK_STRING;
+
+    // "[line:col] " + name padded to 12 + " | " + value/quoted payload + "\n"
+    size_t need = 48 + (name_len > 12 ? name_len : 12) + (has_str ? tok->value.str.len : 0);
+    if (!strbuf_reserve(out, need)) return;
+
+    char *p = out->data + out->len;
+    *p++ = '[';
+    p = put_u64(p, (uint64_t)tok->start.line + 1);
+    *p++ = ':';
+    p = put_u64(p, (uint64_t)tok->start.column + 1);
+    *p++ = ']';
+    *p++ = ' ';
+    memcpy(p, name, name_len);
+    p += name_len;
+    for (size_t k = name_len; k < 12; k++) *p++ = ' ';
+
+    if (tok->type == TOK_INT) {
+        memcpy(p, " | ", 3);
+        p += 3;
+        int64_t v = tok->value.i;
+        if (v < 0) {
+            *p++ = '-';
+            p = put_u64(p, 0 - (uint64_t)v);
+        } else {
+            p = put_u64(p, (uint64_t)v);
+        }
+    } else if (has_str) {
+        memcpy(p, " | '", 4);
+        p += 4;
+        memcpy(p, tok->value.str.ptr, tok->value.str.len);
+        p += tok->value.str.len;
+        *p++ = '\'';
+    }
+
+    out->len = (size_t)(p - out->data);
+
+    if (tok->type == TOK_FLOAT) {
+        strbuf_appendf(out, " | %f", tok->value.f); // rare enough to leave to printf
+    }
+    strbuf_append_byte(out, '\n');
+}
+
+/* ----------------------------
+   Modules
+   ---------------------------- */
+
+// foo/bar.cyl -> foo/bar.cyli
+static int iface_path_for(StrBuf *out, const char *src_path) {
+    size_t n = strlen(src_path);
+    if (n > 4 && strcmp(src_path + n - 4, ".cyl") == 0) n -= 4;
+    out->len = 0;
+    return strbuf_append(out, src_path, n) && strbuf_appendf(out, "%s", IFACE_EXTENSION);
+}
+
+// foo/bar.cyl -> foo/bar.cyltok
+static int tokfile_path_for(StrBuf *out, const char *src_path) {
+    size_t n = strlen(src_path);
+    if (n > 4 && strcmp(src_path + n - 4, ".cyl") == 0) n -= 4;
+    out->len = 0;
+    return strbuf_append(out, src_path, n) && strbuf_appendf(out, "%s", TOKFILE_EXTENSION);
+}
+
+// foo/bar.cyltok -> foo/bar.cyl
+static int source_path_for_tokfile(StrBuf *out, const char *tok_path) {
+    size_t n = strlen(tok_path) - strlen(TOKFILE_EXTENSION);
+    out->len = 0;
+    return strbuf_append(out, tok_path, n) && strbuf_appendf(out, ".cyl");
+}
+
+// `import name` inside dir/file.cyl -> dir/name.cyl
+static int import_source_path(StrBuf *out, const char *importer, StrSlice name) {
+    const char *slash = strrchr(importer, '/');
+    out->len = 0;
+    if (slash && !strbuf_append(out, importer, (size_t)(slash - importer + 1))) return 0;
+    return strbuf_append(out, name.ptr, name.len) && strbuf_appendf(out, ".cyl");
+}
+
+static int emit_interface(CompileJob *job, const char *src_path, const TokenBuffer *tb) {
+    Iface iface;
+    if (!iface_extract(tb, &iface)) {
+        strbuf_appendf(&job->err, "error: out of memory building interface: %s\n", src_path);
+        return 0;
+    }
+
+    StrBuf path;
+    strbuf_init(&path);
+    int written = iface_path_for(&path, src_path) ? iface_write_if_changed(path.data, &iface) : -1;
+    int ok = written >= 0;
+    if (written > 0) STATS_ADD(ifaces_written, 1);
+    else if (written == 0) STATS_ADD(ifaces_unchanged, 1);
+    if (!ok) strbuf_appendf(&job->err, "error: could not write interface: %s\n", path.data ? path.data : src_path);
+
+    strbuf_free(&path);
+    iface_free(&iface);
+    return ok;
+}
+
+static int file_exists(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f) fclose(f);
+    return f != NULL;
+}
+
+/*
+    An import must name a module next to the importer, as source or as a
+    shipped .cyli. Nothing reads the module's exports yet, so this stops at
+    checking that it exists.
+*/
+static int check_import(CompileJob *job, StrSlice name) {
+    StrBuf src_path, iface_path;
+    strbuf_init(&src_path);
+    strbuf_init(&iface_path);
+
+    int ok = import_source_path(&src_path, job->filename, name) &&
+             iface_path_for(&iface_path, src_path.data);
+    if (ok && !file_exists(src_path.data) && !file_exists(iface_path.data)) {
+        strbuf_appendf(&job->err, "%s: error: cannot find module '%.*s'\n",
+                       job->filename, (int)name.len, name.ptr);
+        ok = 0;
+    }
+
+    strbuf_free(&src_path);
+    strbuf_free(&iface_path);
+    return ok;
+}
+
+static int process_modules(CompileJob *job, const TokenBuffer *tb) {
+    int ok = 1;
+
+    if (job->opts->emit_iface) {
+        ok = emit_interface(job, job->filename, tb);
+    }
+
+    const Token *t = tb->items;
+    for (size_t k = 0; k + 1 < tb->count; k++) {
+        if (t[k].type == TOK_KEYWORD && iface_is_import_keyword(t[k].value.str) &&
+            t[k + 1].type == TOK_ID) {
+            if (!check_import(job, t[k + 1].value.str)) ok = 0;
+        }
+    }
+    return ok;
+}
+
+#if STATS_ENABLED
+static void count_tokens(const TokenBuffer *tb) {
+    if (!stats_current) return;
+    for (size_t k = 0; k < tb->count; k++) {
+        unsigned type = (unsigned)tb->items[k].type;
+        if (type < STATS_TOKEN_TYPES) stats_current->tokens[type]++;
+    }
+}
+#endif
+
+static int run_lexer(CompileJob *job, const uint8_t *buffer, size_t size, Cache *cache) {
+    TokenBuffer tb;
+    token_buffer_init(&tb);
+
+    int dump_tokens = job->opts->dump_tokens;
+    uint64_t key = 0;
+    int cached = 0;
+    LexerStatus status = LEX_EOF;
+    int failed = 0;
     Lexer lx;
-    lexer_init(&lx, filename, buffer, size);
-    lexer_set_keyword_fn(&lx, lexer_default_is_keyword);
 
-    Token tok;
-    LexerStatus status;
+    if (cache) {
+        STATS_TIMER_BEGIN(cache_load);
+        key = cache_key(buffer, size, "lex");
+        cached = cache_load_tokens(cache, key, buffer, size, &tb);
+        STATS_TIMER_END(cache_load, STATS_PHASE_CACHE);
+    }
+
+    if (!cached) {
+        STATS_TIMER_BEGIN(lex);
+        lexer_start(&lx, job->filename, buffer, size, job->opts);
+        status = lexer_tokenize(&lx, &tb);
+        STATS_TIMER_END(lex, STATS_PHASE_LEX);
+        STATS_ADD(bytes_decoded, lx.i);
+        failed = lexer_failed(&lx, status);
 
-    while ((status = lexer_next_token(&lx, &tok)) == LEX_OK) {
-        if (!dump_tokens) {
-            continue;
+        // only clean streams are worth keeping; a recovered one still has TOK_ERROR holes
+        if (!failed && cache) {
+            STATS_TIMER_BEGIN(cache_store);
+            cache_store_tokens(cache, key, buffer, size, &tb);
+            STATS_TIMER_END(cache_store, STATS_PHASE_CACHE);
         }
+    }
+
+#if STATS_ENABLED
+    count_tokens(&tb);
+#endif
 
-        printf("[%zu:%zu] %-12s",
-               tok.start.line + 1,
-               tok.start.column + 1,
-               token_type_to_str(tok.type));
-
-        if (tok.type == TOK_INT) {
-            printf(" | %lld", (long long)tok.value.i);
-        } else if (tok.type == TOK_FLOAT) {
-            printf(" | %f", tok.value.f);
-        } else if (tok.type == TOK_ID || tok.type == TOK_KEYWORD || tok.type == TOK_STRING) {
-            printf(" | '%.*s'", (int)tok.value.str.len, tok.value.str.ptr);
+    if (!failed && job->opts->emit_tokens) {
+        StrBuf path, image;
+        strbuf_init(&path);
+        strbuf_init(&image);
+        if (!tokfile_path_for(&path, job->filename) ||
+            !tokfile_build(&tb, cache_key(buffer, size, "lex"), size, &image) ||
+            !tokfile_write(path.data, &image)) {
+            strbuf_appendf(&job->err, "error: could not write token file for: %s\n", job->filename);
+            job->result = 1;
         }
+        strbuf_free(&image);
+        strbuf_free(&path);
+    }
 
-        printf("\n");
+    STATS_TIMER_BEGIN(modules);
+    int modules_ok = !failed ? process_modules(job, &tb) : 1;
+    STATS_TIMER_END(modules, STATS_PHASE_MODULES);
 
-        /* freeing lexer allocated string token memory */
-        if (tok.type == TOK_STRING && tok.value.str.ptr) {
-            free((void *)tok.value.str.ptr);
+    if (dump_tokens) {
+        STATS_TIMER_BEGIN(format);
+        for (size_t k = 0; k < tb.count; k++) {
+            if (tb.items[k].type == TOK_EOF) break;
+            dump_token(&job->out, &tb.items[k]);
         }
+        STATS_TIMER_END(format, STATS_PHASE_FORMAT);
     }
 
-    if (status == LEX_EOF) {
+    token_buffer_free(&tb);
+
+    if (!failed) {
         if (dump_tokens) {
-            printf("Lexing completed successfully.\n");
+            strbuf_appendf(&job->out, "Lexing completed successfully.\n");
         }
-        return 0;
+        return modules_ok ? 0 : 2;
     }
 
-    print_lexer_error(&lx, status);
+    report_lexer_errors(&job->err, &lx, status);
+    lexer_free(&lx);
     return 2;
 }
 
-int main(int argc, char **argv) {
-    int dump_tokens = 0;
-    const char *filename = NULL;
-
-    if (argc == 2) {
-        filename = argv[1];
-    } else if (argc == 3 && strcmp(argv[1], "--tokens") == 0) {
-        dump_tokens = 1;
-        filename = argv[2];
-    } else {
-        print_usage(argv[0]);
+static int has_extension(const char *name, const char *ext) {
+    size_t n = strlen(name), e = strlen(ext);
+    return n > e && strcmp(name + n - e, ext) == 0;
+}
+
+/*
+    Is the image older than the source next to it? Size and mtime come from
+    stat alone; only a newer source costs a read and a hash.
+*/
+static int tokfile_is_stale(const TokFileView *view, const char *tok_path, const char *src_path) {
+    struct stat src_st, tok_st;
+    if (stat(src_path, &src_st) != 0) return 0; // shipped without source: trust the image
+    if ((uint64_t)src_st.st_size != view->header->src_len) return 1;
+    if (stat(tok_path, &tok_st) == 0 && src_st.st_mtime < tok_st.st_mtime) return 0;
+
+    uint8_t *buffer = NULL;
+    size_t size = 0;
+    StrBuf ignored;
+    strbuf_init(&ignored);
+    int stale = !read_entire_file(src_path, &buffer, &size, &ignored) ||
+                cache_key(buffer, size, "lex") != view->header->src_hash;
+    strbuf_free(&ignored);
+    free(buffer);
+    return stale;
+}
+
+/*
+    A .cyltok input is dumped straight from the mapping, nothing is re-lexed.
+    Returns -1 when the image is unusable (corrupt, other version or stale)
+    but src_path names a source to fall back to.
+*/
+static int run_tokfile(CompileJob *job, StrBuf *src_path) {
+    int have_source = 0;
+    if (source_path_for_tokfile(src_path, job->filename)) {
+        struct stat st;
+        have_source = stat(src_path->data, &st) == 0;
+    }
+
+    TokFileView view;
+    if (!tokfile_map(job->filename, &view)) {
+        if (have_source) return -1;
+        strbuf_appendf(&job->err, "error: not a valid token file: %s\n", job->filename);
         return 1;
     }
 
+    if ((job->opts->verify && !tokfile_verify(&view)) || (have_source && tokfile_is_stale(&view, job->filename, src_path->data))) {
+        tokfile_unmap(&view);
+        if (have_source) return -1;
+        strbuf_appendf(&job->err, "error: token file is corrupt: %s\n", job->filename);
+        return 1;
+    }
+
+    if (job->opts->dump_tokens) {
+        Token tok;
+        for (size_t k = 0; k < view.count; k++) {
+            tokfile_get(&view, k, &tok);
+            if (tok.type == TOK_EOF) break;
+            dump_token(&job->out, &tok);
+        }
+        strbuf_appendf(&job->out, "Lexing completed successfully.\n");
+    }
+
+    tokfile_unmap(&view);
+    return 0;
+}
+
+// thread pool entry point: everything for one file, no shared mutable state
+static void compile_file_task(void *arg, unsigned worker) {
+    CompileJob *job = (CompileJob *)arg;
+    STATS_BIND(job->stats ? &job->stats[worker] : NULL);
+
+    const char *input = job->filename;
+    StrBuf src_path;
+    strbuf_init(&src_path);
+
+    if (has_extension(job->filename, TOKFILE_EXTENSION)) {
+        job->result = run_tokfile(job, &src_path);
+        if (job->result >= 0) {
+            strbuf_free(&src_path);
+            return;
+        }
+        // lex the source instead; with --emit-tokens this also refreshes the image
+        strbuf_appendf(&job->err, "note: %s is out of date, using %s\n", job->filename, src_path.data);
+        job->result = 0;
+        job->filename = src_path.data;
+    }
+
     uint8_t *buffer = NULL;
     size_t size = 0;
 
-    if (!read_entire_file(filename, &buffer, &size)) {
+    STATS_TIMER_BEGIN(read);
+    int read_ok = read_entire_file(job->filename, &buffer, &size, &job->err);
+    STATS_TIMER_END(read, STATS_PHASE_READ);
+    if (read_ok) {
+        STATS_ADD(files, 1);
+        STATS_ADD(bytes_read, size);
+
+        Cache *cache = job->caches ? &job->caches[worker] : NULL;
+        int result = run_lexer(job, buffer, size, cache);
+        if (result > job->result) job->result = result;
+    } else {
+        job->result = 1;
+    }
+
+    free(buffer);
+    job->filename = input;
+    strbuf_free(&src_path);
+}
+
+/* ----------------------------
+   Input collection
+   ---------------------------- */
+
+static int file_list_push(FileList *fl, const char *path) {
+    if (fl->count == fl->cap) {
+        size_t cap = fl->cap ? fl->cap * 2 : 16;
+        char **ni = (char **)realloc(fl->items, cap * sizeof(char *));
+        if (!ni) return 0;
+        fl->items = ni;
+        fl->cap = cap;
+    }
+
+    size_t n = strlen(path);
+    char *copy = (char *)malloc(n + 1);
+    if (!copy) return 0;
+    memcpy(copy, path, n + 1);
+    fl->items[fl->count++] = copy;
+    return 1;
+}
+
+static void file_list_free(FileList *fl) {
+    for (size_t k = 0; k < fl->count; k++) free(fl->items[k]);
+    free(fl->items);
+    fl->items = NULL;
+    fl->count = fl->cap = 0;
+}
+
+static int compare_names(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/*
+    Files named on the command line are taken as-is; directories are walked
+    recursively for *.cyl (hidden entries skipped), sorted so output order
+    is stable between runs. The walk follows symlinks to files but not to
+    directories, so a link back up the tree cannot make it loop; a
+    symlinked directory named on the command line is still walked.
+*/
+static int collect_inputs(const char *path, FileList *out, int explicit_arg) {
+    struct stat st;
+    int found = (explicit_arg ? stat(path, &st) : lstat(path, &st)) == 0;
+    if (found && S_ISLNK(st.st_mode)) {
+        found = stat(path, &st) == 0;
+        if (found && S_ISDIR(st.st_mode)) return 1;
+    }
+    if (!found) {
+        if (explicit_arg) return file_list_push(out, path); // let the reader report it
+        return 1;
+    }
+
+    if (!S_ISDIR(st.st_mode)) {
+        if (explicit_arg || has_extension(path, ".cyl")) return file_list_push(out, path);
         return 1;
     }
 
-    int result = run_lexer(filename, buffer, size, dump_tokens);
+    DIR *dir = opendir(path);
+    if (!dir) {
+        fprintf(stderr, "error: could not open directory: %s\n", path);
+        return 0;
+    }
+
+    FileList names = {0};
+    struct dirent *ent;
+    int ok = 1;
+    while (ok && (ent = readdir(dir)) != NULL) {
+        if (ent->d_name[0] == '.') continue;
+        ok = file_list_push(&names, ent->d_name);
+    }
+    closedir(dir);
 
-    free(buffer);
+    if (ok) qsort(names.items, names.count, sizeof(char *), compare_names);
+
+    StrBuf child;
+    strbuf_init(&child);
+    for (size_t k = 0; ok && k < names.count; k++) {
+        child.len = 0;
+        ok = strbuf_appendf(&child, "%s/%s", path, names.items[k]) &&
+             collect_inputs(child.data, out, 0);
+    }
+    strbuf_free(&child);
+    file_list_free(&names);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    Options opts = {0};
+    FileList inputs = {0};
+    opts.max_errors = DEFAULT_MAX_ERRORS;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--tokens") == 0) {
+            opts.dump_tokens = 1;
+        } else if (strcmp(argv[a], "--cache") == 0) {
+            opts.use_cache = 1;
+        } else if (strcmp(argv[a], "--cache-stats") == 0) {
+            opts.use_cache = 1;
+            opts.cache_stats = 1;
+        } else if (strcmp(argv[a], "--cache-dir") == 0 && a + 1 < argc) {
+            opts.use_cache = 1;
+            opts.cache_dir = argv[++a];
+        } else if (strcmp(argv[a], "--emit-tokens") == 0) {
+            opts.emit_tokens = 1;
+        } else if (strcmp(argv[a], "--verify") == 0) {
+            opts.verify = 1;
+        } else if (strcmp(argv[a], "--emit-interface") == 0) {
+            opts.emit_iface = 1;
+        } else if (strcmp(argv[a], "--time-report") == 0 || strcmp(argv[a], "--time-report=json") == 0) {
+            opts.time_report = argv[a][13] == '=' ? 2 : 1;
+        } else if (strcmp(argv[a], "--stats") == 0 || strcmp(argv[a], "--stats=json") == 0) {
+            opts.stats = argv[a][7] == '=' ? 2 : 1;
+        } else if (strcmp(argv[a], "-j") == 0 && a + 1 < argc) {
+            opts.jobs = (unsigned)strtoul(argv[++a], NULL, 10);
+        } else if (strcmp(argv[a], "--max-errors") == 0 && a + 1 < argc) {
+            opts.max_errors = (size_t)strtoul(argv[++a], NULL, 10);
+        } else if (argv[a][0] == '-' && argv[a][1] != '\0') {
+            print_usage(argv[0]);
+            file_list_free(&inputs);
+            return 1;
+        } else if (!collect_inputs(argv[a], &inputs, 1)) {
+            file_list_free(&inputs);
+            return 1;
+        }
+    }
+
+    if (inputs.count == 0) {
+        print_usage(argv[0]);
+        file_list_free(&inputs);
+        return 1;
+    }
+
+#ifdef CEYLONICUS_STATS
+    uint64_t wall_start = stats_now_ns();
+#endif
+    int reporting = opts.time_report || opts.stats;
+    if (reporting && !STATS_ENABLED) {
+        fprintf(stderr, "warning: built without CEYLONICUS_STATS; --time-report/--stats are unavailable\n");
+        reporting = 0;
+    }
+
+    unsigned nthreads = opts.jobs ? opts.jobs : thread_pool_default_threads();
+    if (nthreads > inputs.count) nthreads = (unsigned)inputs.count;
+
+    Cache cache;
+    Cache *caches = NULL;
+    if (opts.use_cache && cache_open(&cache, opts.cache_dir)) {
+        cache.verify = opts.verify;
+        caches = (Cache *)malloc(nthreads * sizeof(Cache));
+        for (unsigned k = 0; caches && k < nthreads; k++) cache_clone(&caches[k], &cache);
+    }
+
+    // slot nthreads collects the serial emit step
+    Stats *stats = reporting ? (Stats *)calloc(nthreads + 1, sizeof(Stats)) : NULL;
+
+    CompileJob *jobs = (CompileJob *)calloc(inputs.count, sizeof(CompileJob));
+    if (!jobs) {
+        fprintf(stderr, "error: out of memory\n");
+        free(stats);
+        free(caches);
+        file_list_free(&inputs);
+        return 1;
+    }
+
+    for (size_t k = 0; k < inputs.count; k++) {
+        jobs[k].filename = inputs.items[k];
+        jobs[k].opts = &opts;
+        jobs[k].caches = caches;
+        jobs[k].stats = stats;
+        strbuf_init(&jobs[k].out);
+        strbuf_init(&jobs[k].err);
+    }
+
+    ThreadPool *pool = nthreads > 1 ? thread_pool_create(nthreads) : NULL;
+    if (pool) {
+        for (size_t k = 0; k < inputs.count; k++) {
+            if (!thread_pool_submit(pool, compile_file_task, &jobs[k])) {
+                strbuf_appendf(&jobs[k].err, "error: out of memory scheduling: %s\n", jobs[k].filename);
+                jobs[k].result = 1;
+            }
+        }
+        thread_pool_destroy(pool);
+    } else {
+        for (size_t k = 0; k < inputs.count; k++) compile_file_task(&jobs[k], 0);
+    }
+
+    /*
+        Serial step: emit per-file results in input order.
+        (Linking the per-file outputs will happen here once there is codegen.)
+    */
+    STATS_BIND(stats ? &stats[nthreads] : NULL);
+    STATS_TIMER_BEGIN(emit);
+    int result = 0;
+    for (size_t k = 0; k < inputs.count; k++) {
+        CompileJob *job = &jobs[k];
+        if (inputs.count > 1 && opts.dump_tokens) printf("==> %s <==\n", job->filename);
+        if (job->out.len) fwrite(job->out.data, 1, job->out.len, stdout);
+        if (job->err.len) {
+            fflush(stdout);
+            fwrite(job->err.data, 1, job->err.len, stderr);
+        }
+        if (job->result > result) result = job->result;
+        strbuf_free(&job->out);
+        strbuf_free(&job->err);
+    }
+    fflush(stdout);
+    STATS_TIMER_END(emit, STATS_PHASE_EMIT);
+
+    if (caches) {
+        for (unsigned k = 0; k < nthreads; k++) cache_merge_stats(&cache, &caches[k]);
+        if (opts.cache_stats) cache_print_stats(&cache, stderr);
+    }
+
+#ifdef CEYLONICUS_STATS
+    if (stats) {
+        uint64_t wall = stats_now_ns() - wall_start;
+        for (unsigned k = 0; k < nthreads; k++) stats_merge(&stats[nthreads], &stats[k]);
+        int json = opts.stats ? opts.stats == 2 : opts.time_report == 2;
+        if (json) stats_print_json(stderr, &stats[nthreads], wall, opts.stats != 0, token_type_to_str);
+        else stats_print_table(stderr, &stats[nthreads], wall, opts.stats != 0, token_type_to_str);
+    }
+#endif
+
+    free(stats);
+    free(jobs);
+    free(caches);
+    file_list_free(&inputs);
     return result;
-}
\ No newline at end of file
+}
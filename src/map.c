@@ -0,0 +1,257 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#include "map.h"
+#include "stats.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CYL_MAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#define CTRL_EMPTY ((int8_t)-128)
+#define CTRL_DELETED ((int8_t)-2)
+// full entries hold the hash's low 7 bits (0..127), so "free" == sign bit set
+
+typedef uint32_t GroupMask; // bit k = slot k of the group
+
+/* ----------------------------
+   Hashing / compare
+   ---------------------------- */
+
+static uint64_t hash_int(int64_t key) {
+    // splitmix64 finalizer: small ints spread over every bit
+    uint64_t x = (uint64_t)key;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t hash_str(StrSlice s) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t k = 0; k < s.len; k++) {
+        h ^= (uint8_t)s.ptr[k];
+        h *= 1099511628211ull;
+    }
+    return h ^ (h >> 32); // FNV's low bits are weak; h2 comes from them
+}
+
+static int str_eq(StrSlice a, StrSlice b) {
+    return a.len == b.len && (a.ptr == b.ptr || memcmp(a.ptr, b.ptr, a.len) == 0);
+}
+
+static uint64_t slot_hash(const CylMap* m, const CylMapSlot* s) {
+    return m->kind == CYL_MAP_INT ? hash_int(s->key.i) : hash_str(s->key.s);
+}
+
+/* ----------------------------
+   Group scanning
+   ---------------------------- */
+
+static GroupMask group_match(const int8_t* g, int8_t h2) {
+#ifdef CYL_MAP_SSE2
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)g);
+    return (GroupMask)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+#else
+    GroupMask mask = 0;
+    for (int k = 0; k < CYL_MAP_GROUP; k++) mask |= (GroupMask)(g[k] == h2) << k;
+    return mask;
+#endif
+}
+
+// empty or deleted
+static GroupMask group_match_free(const int8_t* g) {
+#ifdef CYL_MAP_SSE2
+    return (GroupMask)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)g));
+#else
+    GroupMask mask = 0;
+    for (int k = 0; k < CYL_MAP_GROUP; k++) mask |= (GroupMask)(g[k] < 0) << k;
+    return mask;
+#endif
+}
+
+static unsigned lowest_bit(GroupMask mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctz(mask);
+#else
+    unsigned k = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        k++;
+    }
+    return k;
+#endif
+}
+
+/*
+    Probe sequence: start at group (hash >> 7), then triangular steps
+    (+1, +2, +3, ...), which visit every group of a power-of-two table.
+    The load limit keeps at least one empty entry around, so it terminates.
+    kind is passed as a constant by each public wrapper, so after inlining
+    the int and string versions each get a branch-free compare.
+*/
+static inline CylMapSlot* probe(const CylMap* m, uint64_t hash, int64_t ikey, StrSlice skey,
+                                CylMapKeyKind kind) {
+    if (!m->cap) return NULL;
+
+    size_t group_mask = m->cap / CYL_MAP_GROUP - 1;
+    size_t g = (size_t)(hash >> 7) & group_mask;
+    int8_t h2 = (int8_t)(hash & 0x7F);
+
+    for (size_t step = 1;; step++) {
+        const int8_t* ctrl = m->ctrl + g * CYL_MAP_GROUP;
+        for (GroupMask match = group_match(ctrl, h2); match; match &= match - 1) {
+            CylMapSlot* s = &m->slots[g * CYL_MAP_GROUP + lowest_bit(match)];
+            if (kind == CYL_MAP_INT ? s->key.i == ikey : str_eq(s->key.s, skey)) return s;
+        }
+        if (group_match(ctrl, CTRL_EMPTY)) return NULL;
+        g = (g + step) & group_mask;
+    }
+}
+
+static size_t find_free(const CylMap* m, uint64_t hash) {
+    size_t group_mask = m->cap / CYL_MAP_GROUP - 1;
+    size_t g = (size_t)(hash >> 7) & group_mask;
+
+    for (size_t step = 1;; step++) {
+        GroupMask free_mask = group_match_free(m->ctrl + g * CYL_MAP_GROUP);
+        if (free_mask) return g * CYL_MAP_GROUP + lowest_bit(free_mask);
+        g = (g + step) & group_mask;
+    }
+}
+
+/* ----------------------------
+   Storage
+   ---------------------------- */
+
+static size_t load_limit(size_t cap) {
+    return cap - cap / 8;
+}
+
+static int rehash(CylMap* m, size_t new_cap) {
+    int8_t* ctrl = (int8_t*)malloc(new_cap);
+    CylMapSlot* slots = (CylMapSlot*)malloc(new_cap * sizeof(CylMapSlot));
+    if (!ctrl || !slots) {
+        free(ctrl);
+        free(slots);
+        return 0;
+    }
+    STATS_ALLOC(new_cap * (1 + sizeof(CylMapSlot)));
+    memset(ctrl, CTRL_EMPTY, new_cap);
+
+    CylMap grown = *m;
+    grown.ctrl = ctrl;
+    grown.slots = slots;
+    grown.cap = new_cap;
+    grown.tombstones = 0;
+
+    for (size_t k = 0; k < m->cap; k++) {
+        if (m->ctrl[k] < 0) continue;
+        uint64_t hash = slot_hash(m, &m->slots[k]);
+        size_t at = find_free(&grown, hash);
+        ctrl[at] = (int8_t)(hash & 0x7F);
+        slots[at] = m->slots[k];
+    }
+
+    free(m->ctrl);
+    free(m->slots);
+    *m = grown;
+    return 1;
+}
+
+int cyl_map_init(CylMap* m, CylMapKeyKind kind, size_t expected) {
+    memset(m, 0, sizeof(*m));
+    m->kind = kind;
+    if (!expected) return 1;
+
+    size_t cap = CYL_MAP_GROUP;
+    while (load_limit(cap) < expected) cap *= 2;
+    return rehash(m, cap);
+}
+
+void cyl_map_free(CylMap* m) {
+    free(m->ctrl);
+    free(m->slots);
+    memset(m, 0, sizeof(*m));
+}
+
+static uint64_t* insert_new(CylMap* m, uint64_t hash, int64_t ikey, StrSlice skey) {
+    if (m->count + m->tombstones + 1 > load_limit(m->cap)) {
+        // mostly tombstones: clean up in place; otherwise grow
+        size_t cap = !m->cap ? CYL_MAP_GROUP
+                   : m->count + 1 > load_limit(m->cap) / 2 ? m->cap * 2 : m->cap;
+        if (!rehash(m, cap)) return NULL;
+    }
+
+    size_t at = find_free(m, hash);
+    if (m->ctrl[at] == CTRL_DELETED) m->tombstones--;
+    m->ctrl[at] = (int8_t)(hash & 0x7F);
+    m->count++;
+
+    CylMapSlot* s = &m->slots[at];
+    if (m->kind == CYL_MAP_INT) s->key.i = ikey;
+    else s->key.s = skey;
+    s->value = 0;
+    return &s->value;
+}
+
+static void erase(CylMap* m, CylMapSlot* s) {
+    size_t at = (size_t)(s - m->slots);
+    const int8_t* group = m->ctrl + at / CYL_MAP_GROUP * CYL_MAP_GROUP;
+    // probes stop at a group with an empty entry, so nothing was placed past this one
+    if (group_match(group, CTRL_EMPTY)) {
+        m->ctrl[at] = CTRL_EMPTY;
+    } else {
+        m->ctrl[at] = CTRL_DELETED;
+        m->tombstones++;
+    }
+    m->count--;
+}
+
+/* ----------------------------
+   Public API
+   ---------------------------- */
+
+static const StrSlice NO_STR = { NULL, 0 };
+
+uint64_t* cyl_map_find_int(const CylMap* m, int64_t key) {
+    CylMapSlot* s = probe(m, hash_int(key), key, NO_STR, CYL_MAP_INT);
+    return s ? &s->value : NULL;
+}
+
+uint64_t* cyl_map_find_str(const CylMap* m, StrSlice key) {
+    CylMapSlot* s = probe(m, hash_str(key), 0, key, CYL_MAP_STR);
+    return s ? &s->value : NULL;
+}
+
+uint64_t* cyl_map_upsert_int(CylMap* m, int64_t key, int* inserted) {
+    uint64_t hash = hash_int(key);
+    CylMapSlot* s = probe(m, hash, key, NO_STR, CYL_MAP_INT);
+    *inserted = !s;
+    return s ? &s->value : insert_new(m, hash, key, NO_STR);
+}
+
+uint64_t* cyl_map_upsert_str(CylMap* m, StrSlice key, int* inserted) {
+    uint64_t hash = hash_str(key);
+    CylMapSlot* s = probe(m, hash, 0, key, CYL_MAP_STR);
+    *inserted = !s;
+    return s ? &s->value : insert_new(m, hash, 0, key);
+}
+
+int cyl_map_remove_int(CylMap* m, int64_t key) {
+    CylMapSlot* s = probe(m, hash_int(key), key, NO_STR, CYL_MAP_INT);
+    if (s) erase(m, s);
+    return s != NULL;
+}
+
+int cyl_map_remove_str(CylMap* m, StrSlice key) {
+    CylMapSlot* s = probe(m, hash_str(key), 0, key, CYL_MAP_STR);
+    if (s) erase(m, s);
+    return s != NULL;
+}
@@ -0,0 +1,116 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "mapfile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <process.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+int map_file(const char* path, MappedFile* out) {
+    memset(out, 0, sizeof(*out));
+
+#ifdef _WIN32
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long sz = ftell(f);
+    rewind(f);
+    if (sz <= 0) { fclose(f); return 0; }
+    uint8_t* mem = (uint8_t*)malloc((size_t)sz);
+    if (!mem || fread(mem, 1, (size_t)sz, f) != (size_t)sz) { free(mem); fclose(f); return 0; }
+    fclose(f);
+    out->data = mem;
+    out->size = (size_t)sz;
+    out->mapped = 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    int ok = map_fd(fd, out);
+    close(fd);
+    if (!ok) return 0;
+#endif
+    return 1;
+}
+
+int map_fd(int fd, MappedFile* out) {
+    memset(out, 0, sizeof(*out));
+
+#ifdef _WIN32
+    (void)fd;
+    return 0;
+#else
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) return 0;
+
+    void* mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mem == MAP_FAILED) return 0;
+
+    out->data = (const uint8_t*)mem;
+    out->size = (size_t)st.st_size;
+    out->mapped = 1;
+    return 1;
+#endif
+}
+
+void unmap_file(MappedFile* mf) {
+    if (!mf->data) return;
+#ifndef _WIN32
+    if (mf->mapped) munmap((void*)mf->data, mf->size);
+    else free((void*)mf->data);
+#else
+    free((void*)mf->data);
+#endif
+    memset(mf, 0, sizeof(*mf));
+}
+
+/* ----------------------------
+   Writing
+   ---------------------------- */
+
+// unique within the process, across threads
+static unsigned long next_temp_id(void) {
+#ifdef _WIN32
+    static volatile LONG counter;
+    return (unsigned long)InterlockedIncrement(&counter);
+#else
+    static unsigned long counter;
+    return __atomic_add_fetch(&counter, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+int write_file_atomic(const char* path, const void* data, size_t len) {
+    char tmp[4200];
+#ifdef _WIN32
+    long pid = (long)_getpid();
+#else
+    long pid = (long)getpid();
+#endif
+    snprintf(tmp, sizeof(tmp), "%s.%ld.%lu.tmp", path, pid, next_temp_id());
+
+    FILE* f = fopen(tmp, "wb");
+    if (!f) return 0;
+    int ok = fwrite(data, 1, len, f) == len;
+    if (fclose(f) != 0) ok = 0;
+
+#ifdef _WIN32
+    if (ok) remove(path); // rename does not replace on Windows
+#endif
+    if (ok && rename(tmp, path) != 0) ok = 0;
+    if (!ok) remove(tmp);
+    return ok;
+}
@@ -0,0 +1,88 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#include "numparse.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static int is_digit(uint8_t c) {
+    return c >= '0' && c <= '9';
+}
+
+size_t num_scan(const uint8_t* s, size_t len, int* is_float) {
+    size_t k = 0;
+    int dots = 0;
+    while (k < len) {
+        if (is_digit(s[k])) {
+            k++;
+        } else if (s[k] == '.' && !dots) {
+            dots = 1;
+            k++;
+        } else {
+            break;
+        }
+    }
+
+    *is_float = dots;
+    if (k == 1 && dots) return 0; // lone "."
+    return k;
+}
+
+int num_parse_u64(const char* s, size_t n, uint64_t* out) {
+    uint64_t v = 0;
+    for (size_t k = 0; k < n; k++) {
+        unsigned d = (unsigned)(s[k] - '0');
+        if (v > (UINT64_MAX - d) / 10) return 0;
+        v = v * 10 + d;
+    }
+    *out = v;
+    return 1;
+}
+
+int64_t num_parse_int(const char* s, size_t n) {
+    uint64_t v;
+    if (!num_parse_u64(s, n, &v) || v > (uint64_t)INT64_MAX) return INT64_MAX;
+    return (int64_t)v;
+}
+
+/*
+    Clinger's fast path: with at most 15 significant digits the mantissa is
+    an exact double, and so is 10^k for k <= 22, so one IEEE division gives
+    the correctly rounded result. Anything longer goes through strtod, from
+    a stack copy for ordinary lengths.
+*/
+static const double POW10[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+double num_parse_float(const char* s, size_t n) {
+    uint64_t mantissa = 0;
+    int digits = 0, frac = 0, seen_dot = 0;
+    for (size_t k = 0; k < n; k++) {
+        if (s[k] == '.') {
+            seen_dot = 1;
+            continue;
+        }
+        if (digits == 0 && s[k] == '0') { // leading zeros are not significant
+            if (seen_dot) frac++;
+            continue;
+        }
+        mantissa = mantissa * 10 + (uint64_t)(s[k] - '0');
+        digits++;
+        if (seen_dot) frac++;
+        if (digits > 15) break;
+    }
+    if (digits <= 15 && frac <= 22) return (double)mantissa / POW10[frac];
+
+    char stack[64];
+    char* tmp = n < sizeof(stack) ? stack : (char*)malloc(n + 1);
+    if (!tmp) return 0.0;
+    memcpy(tmp, s, n);
+    tmp[n] = '\0';
+    double v = strtod(tmp, NULL);
+    if (tmp != stack) free(tmp);
+    return v;
+}
@@ -0,0 +1,127 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "stats.h"
+
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef CEYLONICUS_STATS
+STATS_THREAD_LOCAL Stats* stats_current = NULL;
+#endif
+
+static const char* const PHASE_NAMES[STATS_PHASE_COUNT] = {
+    "read", "cache", "lex", "modules", "format", "emit"
+};
+
+uint64_t stats_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+void stats_merge(Stats* dst, const Stats* src) {
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        dst->phase_ns[p] += src->phase_ns[p];
+        dst->phase_calls[p] += src->phase_calls[p];
+    }
+    for (int t = 0; t < STATS_TOKEN_TYPES; t++) dst->tokens[t] += src->tokens[t];
+
+    dst->files += src->files;
+    dst->bytes_read += src->bytes_read;
+    dst->bytes_decoded += src->bytes_decoded;
+    dst->ifaces_written += src->ifaces_written;
+    dst->ifaces_unchanged += src->ifaces_unchanged;
+    dst->allocs += src->allocs;
+    dst->alloc_bytes += src->alloc_bytes;
+    if (src->token_buffer_peak > dst->token_buffer_peak) dst->token_buffer_peak = src->token_buffer_peak;
+}
+
+static uint64_t total_tokens(const Stats* s) {
+    uint64_t n = 0;
+    for (int t = 0; t < STATS_TOKEN_TYPES; t++) n += s->tokens[t];
+    return n;
+}
+
+void stats_print_table(FILE* out, const Stats* s, uint64_t wall_ns, int counters, StatsTokenNameFn name) {
+    // phase times are summed over workers, so they can exceed wall time with -j
+    fprintf(out, "%-10s %12s %8s %10s\n", "phase", "time (ms)", "calls", "% of wall");
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        if (!s->phase_calls[p]) continue;
+        fprintf(out, "%-10s %12.3f %8llu %9.1f%%\n",
+                PHASE_NAMES[p],
+                (double)s->phase_ns[p] / 1e6,
+                (unsigned long long)s->phase_calls[p],
+                wall_ns ? 100.0 * (double)s->phase_ns[p] / (double)wall_ns : 0.0);
+    }
+    fprintf(out, "%-10s %12.3f\n", "wall", (double)wall_ns / 1e6);
+
+    if (!counters) return;
+
+    fprintf(out, "\n%-24s %14s\n", "counter", "value");
+    fprintf(out, "%-24s %14llu\n", "files", (unsigned long long)s->files);
+    fprintf(out, "%-24s %14llu\n", "bytes read", (unsigned long long)s->bytes_read);
+    fprintf(out, "%-24s %14llu\n", "bytes decoded", (unsigned long long)s->bytes_decoded);
+    fprintf(out, "%-24s %14llu\n", "tokens", (unsigned long long)total_tokens(s));
+    fprintf(out, "%-24s %14llu\n", "interfaces written", (unsigned long long)s->ifaces_written);
+    fprintf(out, "%-24s %14llu\n", "interfaces unchanged", (unsigned long long)s->ifaces_unchanged);
+    fprintf(out, "%-24s %14llu\n", "heap allocations", (unsigned long long)s->allocs);
+    fprintf(out, "%-24s %14llu\n", "heap bytes", (unsigned long long)s->alloc_bytes);
+    fprintf(out, "%-24s %14llu\n", "token buffer peak bytes", (unsigned long long)s->token_buffer_peak);
+
+    fprintf(out, "\n%-24s %14s\n", "token type", "count");
+    for (int t = 0; t < STATS_TOKEN_TYPES; t++) {
+        if (!s->tokens[t]) continue;
+        fprintf(out, "%-24s %14llu\n", name((TokenType)t), (unsigned long long)s->tokens[t]);
+    }
+}
+
+void stats_print_json(FILE* out, const Stats* s, uint64_t wall_ns, int counters, StatsTokenNameFn name) {
+    fprintf(out, "{\n  \"wall_ns\": %llu,\n  \"phases\": {", (unsigned long long)wall_ns);
+    int first = 1;
+    for (int p = 0; p < STATS_PHASE_COUNT; p++) {
+        if (!s->phase_calls[p]) continue;
+        fprintf(out, "%s\n    \"%s\": {\"ns\": %llu, \"calls\": %llu}",
+                first ? "" : ",", PHASE_NAMES[p],
+                (unsigned long long)s->phase_ns[p], (unsigned long long)s->phase_calls[p]);
+        first = 0;
+    }
+    fprintf(out, "\n  }");
+
+    if (counters) {
+        fprintf(out, ",\n  \"counters\": {\n");
+        fprintf(out, "    \"files\": %llu,\n", (unsigned long long)s->files);
+        fprintf(out, "    \"bytes_read\": %llu,\n", (unsigned long long)s->bytes_read);
+        fprintf(out, "    \"bytes_decoded\": %llu,\n", (unsigned long long)s->bytes_decoded);
+        fprintf(out, "    \"tokens\": %llu,\n", (unsigned long long)total_tokens(s));
+        fprintf(out, "    \"interfaces_written\": %llu,\n", (unsigned long long)s->ifaces_written);
+        fprintf(out, "    \"interfaces_unchanged\": %llu,\n", (unsigned long long)s->ifaces_unchanged);
+        fprintf(out, "    \"heap_allocations\": %llu,\n", (unsigned long long)s->allocs);
+        fprintf(out, "    \"heap_bytes\": %llu,\n", (unsigned long long)s->alloc_bytes);
+        fprintf(out, "    \"token_buffer_peak_bytes\": %llu\n", (unsigned long long)s->token_buffer_peak);
+        fprintf(out, "  },\n  \"tokens\": {");
+        first = 1;
+        for (int t = 0; t < STATS_TOKEN_TYPES; t++) {
+            if (!s->tokens[t]) continue;
+            fprintf(out, "%s\n    \"%s\": %llu", first ? "" : ",", name((TokenType)t),
+                    (unsigned long long)s->tokens[t]);
+            first = 0;
+        }
+        fprintf(out, "\n  }");
+    }
+    fprintf(out, "\n}\n");
+}
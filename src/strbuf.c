@@ -0,0 +1,101 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+
+#include "strbuf.h"
+#include "utf8.h"
+#include "stats.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STRBUF_MIN_CAP 32
+
+void strbuf_init(StrBuf* sb) {
+    sb->data = NULL;
+    sb->len = 0;
+    sb->cap = 0;
+}
+
+int strbuf_reserve(StrBuf* sb, size_t extra) {
+    size_t need = sb->len + extra + 1; // keep room for '\0'
+    if (need < sb->len) return 0; // overflow
+    if (need <= sb->cap) return 1;
+
+    size_t cap = sb->cap ? sb->cap : STRBUF_MIN_CAP;
+    while (cap < need) {
+        if (cap > ((size_t)-1) / 2) { cap = need; break; }
+        cap *= 2;
+    }
+
+    char* nb = (char*)realloc(sb->data, cap);
+    if (!nb) return 0;
+    STATS_ALLOC(cap);
+    sb->data = nb;
+    sb->cap = cap;
+    return 1;
+}
+
+int strbuf_append(StrBuf* sb, const char* s, size_t n) {
+    if (n == 0) return 1;
+    if (!strbuf_reserve(sb, n)) return 0;
+    memcpy(sb->data + sb->len, s, n);
+    sb->len += n;
+    sb->data[sb->len] = '\0';
+    return 1;
+}
+
+int strbuf_append_byte(StrBuf* sb, char c) {
+    if (sb->len + 1 >= sb->cap && !strbuf_reserve(sb, 1)) return 0;
+    sb->data[sb->len++] = c;
+    sb->data[sb->len] = '\0';
+    return 1;
+}
+
+int strbuf_appendf(StrBuf* sb, const char* fmt, ...) {
+    char small[256];
+    va_list ap;
+
+    va_start(ap, fmt);
+    int n = vsnprintf(small, sizeof(small), fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    if ((size_t)n < sizeof(small)) return strbuf_append(sb, small, (size_t)n);
+
+    if (!strbuf_reserve(sb, (size_t)n)) return 0;
+    va_start(ap, fmt);
+    vsnprintf(sb->data + sb->len, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    sb->len += (size_t)n;
+    return 1;
+}
+
+int strbuf_append_cp(StrBuf* sb, uint32_t cp) {
+    if (!strbuf_reserve(sb, 4)) return 0;
+    sb->len += utf8_encode(cp, (uint8_t*)sb->data + sb->len);
+    sb->data[sb->len] = '\0';
+    return 1;
+}
+
+char* strbuf_detach(StrBuf* sb, size_t* out_len) {
+    char* out;
+    if (!sb->data) {
+        out = (char*)malloc(1);
+        if (!out) return NULL;
+    } else {
+        out = (char*)realloc(sb->data, sb->len + 1);
+        if (!out) return NULL;
+    }
+    out[sb->len] = '\0';
+    if (out_len) *out_len = sb->len;
+    strbuf_init(sb);
+    return out;
+}
+
+void strbuf_free(StrBuf* sb) {
+    free(sb->data);
+    strbuf_init(sb);
+}
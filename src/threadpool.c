@@ -0,0 +1,306 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "threadpool.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+typedef struct Task {
+    ThreadPoolTaskFn fn;
+    void* arg;
+} Task;
+
+// ring buffer: top is where thieves take from, bottom is the owner's end
+typedef struct Deque {
+    pthread_mutex_t lock;
+    Task* tasks;
+    size_t cap;
+    size_t top;
+    size_t count;
+} Deque;
+
+typedef struct Worker {
+    ThreadPool* pool;
+    unsigned id;
+    pthread_t thread;
+} Worker;
+
+struct ThreadPool {
+    unsigned nthreads;
+    Worker* workers;
+    Deque* deques;
+
+    pthread_mutex_t lock; // guards pending/queued/shutdown and the condvars
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+    size_t pending; // submitted but not finished
+    size_t queued; // sitting in some deque
+    int shutdown;
+
+    unsigned next_victim; // round-robin target for external submits
+};
+
+static pthread_key_t tls_worker;
+static pthread_once_t tls_once = PTHREAD_ONCE_INIT;
+
+static void tls_init(void) {
+    pthread_key_create(&tls_worker, NULL);
+}
+
+/* ----------------------------
+   Deque
+   ---------------------------- */
+
+static int deque_init(Deque* d) {
+    d->cap = 64;
+    d->top = 0;
+    d->count = 0;
+    d->tasks = (Task*)malloc(d->cap * sizeof(Task));
+    if (!d->tasks) return 0;
+    pthread_mutex_init(&d->lock, NULL);
+    return 1;
+}
+
+static void deque_free(Deque* d) {
+    pthread_mutex_destroy(&d->lock);
+    free(d->tasks);
+}
+
+static int deque_push_bottom(Deque* d, Task t) {
+    pthread_mutex_lock(&d->lock);
+    if (d->count == d->cap) {
+        size_t cap = d->cap * 2;
+        Task* nt = (Task*)malloc(cap * sizeof(Task));
+        if (!nt) {
+            pthread_mutex_unlock(&d->lock);
+            return 0;
+        }
+        for (size_t k = 0; k < d->count; k++) nt[k] = d->tasks[(d->top + k) % d->cap];
+        free(d->tasks);
+        d->tasks = nt;
+        d->cap = cap;
+        d->top = 0;
+    }
+    d->tasks[(d->top + d->count) % d->cap] = t;
+    d->count++;
+    pthread_mutex_unlock(&d->lock);
+    return 1;
+}
+
+static int deque_pop_bottom(Deque* d, Task* out) {
+    int ok = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->count) {
+        d->count--;
+        *out = d->tasks[(d->top + d->count) % d->cap];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+static int deque_steal_top(Deque* d, Task* out) {
+    int ok = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->count) {
+        *out = d->tasks[d->top];
+        d->top = (d->top + 1) % d->cap;
+        d->count--;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+/* ----------------------------
+   Workers
+   ---------------------------- */
+
+static int find_task(ThreadPool* pool, unsigned self, Task* out) {
+    if (deque_pop_bottom(&pool->deques[self], out)) return 1;
+
+    for (unsigned k = 1; k < pool->nthreads; k++) {
+        unsigned victim = (self + k) % pool->nthreads;
+        if (deque_steal_top(&pool->deques[victim], out)) return 1;
+    }
+    return 0;
+}
+
+static void* worker_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    ThreadPool* pool = w->pool;
+    pthread_setspecific(tls_worker, w);
+
+    for (;;) {
+        Task t;
+        if (find_task(pool, w->id, &t)) {
+            pthread_mutex_lock(&pool->lock);
+            pool->queued--;
+            pthread_mutex_unlock(&pool->lock);
+
+            t.fn(t.arg, w->id);
+
+            pthread_mutex_lock(&pool->lock);
+            if (--pool->pending == 0) pthread_cond_broadcast(&pool->done_cv);
+            pthread_mutex_unlock(&pool->lock);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        while (pool->queued == 0 && !pool->shutdown) {
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        }
+        int stop = pool->shutdown && pool->queued == 0;
+        pthread_mutex_unlock(&pool->lock);
+        if (stop) break;
+    }
+    return NULL;
+}
+
+/* ----------------------------
+   Public API
+   ---------------------------- */
+
+unsigned thread_pool_default_threads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors ? (unsigned)si.dwNumberOfProcessors : 1u;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (unsigned)n : 1u;
+#endif
+}
+
+ThreadPool* thread_pool_create(unsigned nthreads) {
+    if (nthreads == 0) nthreads = 1;
+    pthread_once(&tls_once, tls_init);
+
+    ThreadPool* pool = (ThreadPool*)calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+
+    pool->nthreads = nthreads;
+    pool->workers = (Worker*)calloc(nthreads, sizeof(Worker));
+    pool->deques = (Deque*)calloc(nthreads, sizeof(Deque));
+    if (!pool->workers || !pool->deques) {
+        free(pool->workers);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+
+    unsigned made_deques = 0;
+    for (; made_deques < nthreads; made_deques++) {
+        if (!deque_init(&pool->deques[made_deques])) break;
+    }
+
+    unsigned started = 0;
+    if (made_deques == nthreads) {
+        for (; started < nthreads; started++) {
+            Worker* w = &pool->workers[started];
+            w->pool = pool;
+            w->id = started;
+            if (pthread_create(&w->thread, NULL, worker_main, w) != 0) break;
+        }
+    }
+
+    if (started != nthreads) {
+        pthread_mutex_lock(&pool->lock);
+        pool->shutdown = 1;
+        pthread_cond_broadcast(&pool->work_cv);
+        pthread_mutex_unlock(&pool->lock);
+        for (unsigned k = 0; k < started; k++) pthread_join(pool->workers[k].thread, NULL);
+        for (unsigned k = 0; k < made_deques; k++) deque_free(&pool->deques[k]);
+        pthread_cond_destroy(&pool->done_cv);
+        pthread_cond_destroy(&pool->work_cv);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool->workers);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+unsigned thread_pool_size(const ThreadPool* pool) {
+    return pool->nthreads;
+}
+
+int thread_pool_submit(ThreadPool* pool, ThreadPoolTaskFn fn, void* arg) {
+    Task t;
+    t.fn = fn;
+    t.arg = arg;
+
+    // from inside a worker: keep the task local, otherwise spread round-robin
+    Worker* self = (Worker*)pthread_getspecific(tls_worker);
+    unsigned target;
+    if (self && self->pool == pool) {
+        target = self->id;
+    } else {
+        pthread_mutex_lock(&pool->lock);
+        target = pool->next_victim;
+        pool->next_victim = (pool->next_victim + 1) % pool->nthreads;
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->pending++;
+    pool->queued++;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (!deque_push_bottom(&pool->deques[target], t)) {
+        pthread_mutex_lock(&pool->lock);
+        pool->queued--;
+        if (--pool->pending == 0) pthread_cond_broadcast(&pool->done_cv);
+        pthread_mutex_unlock(&pool->lock);
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+    return 1;
+}
+
+void thread_pool_wait(ThreadPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending) pthread_cond_wait(&pool->done_cv, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_destroy(ThreadPool* pool) {
+    if (!pool) return;
+    thread_pool_wait(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (unsigned k = 0; k < pool->nthreads; k++) {
+        pthread_join(pool->workers[k].thread, NULL);
+        deque_free(&pool->deques[k]);
+    }
+
+    pthread_cond_destroy(&pool->done_cv);
+    pthread_cond_destroy(&pool->work_cv);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool->deques);
+    free(pool);
+}
@@ -0,0 +1,333 @@
+/*
+    Author: RezSat <yehanwasura@duck.com>
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "tokfile.h"
+#include "map.h"
+#include "stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t SECTION_ELEM_SIZE[TOKFILE_SEC_COUNT] = {
+    sizeof(uint8_t),
+    sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t),
+    sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t),
+    sizeof(uint64_t),
+    sizeof(uint32_t), sizeof(uint32_t),
+    sizeof(char)
+};
+
+static int has_payload(TokenType t) {
+    return t == TOK_ID || t == TOK_KEYWORD || t == TOK_STRING;
+}
+
+static size_t align8(size_t n) {
+    return (n + 7u) & ~(size_t)7u;
+}
+
+/*
+    Not FNV-1a: FNV's constants, but one 64-bit word per step and an
+    xorshift after each multiply so high bits feed back into the low ones.
+    n must be a multiple of 8 and data 8-byte aligned.
+*/
+static uint64_t checksum_words(uint64_t h, const void* data, size_t n) {
+    const uint64_t* w = (const uint64_t*)data;
+    for (size_t k = 0; k < n / 8; k++) {
+        h ^= w[k];
+        h *= 1099511628211ull;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+// the whole image, header included, with the checksum field read as 0
+static uint64_t image_checksum(const uint8_t* image, size_t len) {
+    TokFileHeader h;
+    memcpy(&h, image, sizeof(h));
+    h.checksum = 0;
+    uint64_t sum = checksum_words(1469598103934665603ull, &h, sizeof(h));
+    return checksum_words(sum, image + sizeof(h), len - sizeof(h));
+}
+
+/* ----------------------------
+   String interning
+   ---------------------------- */
+
+typedef struct InternTable {
+    CylMap index; // string -> position in strings
+    StrSlice* strings; // distinct strings in first-seen order
+    size_t count;
+    size_t bytes;
+} InternTable;
+
+static int intern_init(InternTable* t, size_t expected) {
+    memset(t, 0, sizeof(*t));
+    t->strings = (StrSlice*)malloc((expected ? expected : 1) * sizeof(StrSlice));
+    STATS_ALLOC(expected * sizeof(StrSlice));
+    // most payloads repeat; let the index grow to the distinct count
+    return cyl_map_init(&t->index, CYL_MAP_STR, 0) && t->strings;
+}
+
+static void intern_free(InternTable* t) {
+    cyl_map_free(&t->index);
+    free(t->strings);
+    memset(t, 0, sizeof(*t));
+}
+
+// strings is sized up front for the worst case (every payload distinct); UINT32_MAX on out of memory
+static uint32_t intern(InternTable* t, StrSlice s) {
+    int inserted = 0;
+    uint64_t* slot = cyl_map_upsert_str(&t->index, s, &inserted);
+    if (!slot) return UINT32_MAX;
+    if (!inserted) return (uint32_t)*slot;
+
+    t->strings[t->count] = s;
+    t->bytes += s.len;
+    *slot = t->count;
+    return (uint32_t)t->count++;
+}
+
+/* ----------------------------
+   Writing
+   ---------------------------- */
+
+int tokfile_build(const TokenBuffer* tb, uint64_t src_hash, size_t src_len, StrBuf* out) {
+    size_t n = tb->count;
+    if ((uint64_t)src_len > UINT32_MAX) return 0;
+
+    size_t payloads = 0;
+    for (size_t k = 0; k < n; k++) payloads += has_payload(tb->items[k].type);
+
+    InternTable strings;
+    if (!intern_init(&strings, payloads)) {
+        intern_free(&strings);
+        return 0;
+    }
+
+    // value column is filled during interning, before the image is laid out
+    uint64_t* values = (uint64_t*)malloc((n ? n : 1) * sizeof(uint64_t));
+    if (!values) {
+        intern_free(&strings);
+        return 0;
+    }
+    STATS_ALLOC(n * sizeof(uint64_t));
+
+    for (size_t k = 0; k < n; k++) {
+        const Token* t = &tb->items[k];
+        if (has_payload(t->type)) {
+            uint32_t id = intern(&strings, t->value.str);
+            if (id == UINT32_MAX) {
+                free(values);
+                intern_free(&strings);
+                return 0;
+            }
+            values[k] = id;
+        } else if (t->type == TOK_FLOAT) {
+            memcpy(&values[k], &t->value.f, sizeof(double));
+        } else {
+            values[k] = (uint64_t)t->value.i;
+        }
+    }
+
+    size_t counts[TOKFILE_SEC_COUNT];
+    for (int s = 0; s < TOKFILE_SEC_COUNT; s++) counts[s] = n;
+    counts[TOKFILE_SEC_STR_OFF] = strings.count;
+    counts[TOKFILE_SEC_STR_LEN] = strings.count;
+    counts[TOKFILE_SEC_STR_DATA] = strings.bytes;
+
+    TokFileHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = TOKFILE_MAGIC;
+    h.version = TOKFILE_VERSION;
+    h.src_hash = src_hash;
+    h.src_len = src_len;
+    h.token_count = n;
+    h.string_count = strings.count;
+    h.strings_len = strings.bytes;
+
+    size_t total = align8(sizeof(TokFileHeader));
+    for (int s = 0; s < TOKFILE_SEC_COUNT; s++) {
+        h.sections[s] = total;
+        total = align8(total + counts[s] * SECTION_ELEM_SIZE[s]);
+    }
+
+    out->len = 0;
+    if (strings.bytes > UINT32_MAX || !strbuf_reserve(out, total)) {
+        free(values);
+        intern_free(&strings);
+        return 0;
+    }
+
+    uint8_t* base = (uint8_t*)out->data;
+    memset(base, 0, total);
+    memcpy(base, &h, sizeof(h));
+
+    uint8_t* type = base + h.sections[TOKFILE_SEC_TYPE];
+    uint32_t* si = (uint32_t*)(base + h.sections[TOKFILE_SEC_START_INDEX]);
+    uint32_t* sl = (uint32_t*)(base + h.sections[TOKFILE_SEC_START_LINE]);
+    uint32_t* sc = (uint32_t*)(base + h.sections[TOKFILE_SEC_START_COL]);
+    uint32_t* ei = (uint32_t*)(base + h.sections[TOKFILE_SEC_END_INDEX]);
+    uint32_t* el = (uint32_t*)(base + h.sections[TOKFILE_SEC_END_LINE]);
+    uint32_t* ec = (uint32_t*)(base + h.sections[TOKFILE_SEC_END_COL]);
+
+    for (size_t k = 0; k < n; k++) {
+        const Token* t = &tb->items[k];
+        type[k] = (uint8_t)t->type;
+        si[k] = (uint32_t)t->start.index;
+        sl[k] = (uint32_t)t->start.line;
+        sc[k] = (uint32_t)t->start.column;
+        ei[k] = (uint32_t)t->end.index;
+        el[k] = (uint32_t)t->end.line;
+        ec[k] = (uint32_t)t->end.column;
+    }
+    memcpy(base + h.sections[TOKFILE_SEC_VALUE], values, n * sizeof(uint64_t));
+
+    uint32_t* soff = (uint32_t*)(base + h.sections[TOKFILE_SEC_STR_OFF]);
+    uint32_t* slen = (uint32_t*)(base + h.sections[TOKFILE_SEC_STR_LEN]);
+    char* sdata = (char*)(base + h.sections[TOKFILE_SEC_STR_DATA]);
+    uint32_t off = 0;
+    for (size_t k = 0; k < strings.count; k++) {
+        soff[k] = off;
+        slen[k] = (uint32_t)strings.strings[k].len;
+        memcpy(sdata + off, strings.strings[k].ptr, strings.strings[k].len);
+        off += (uint32_t)strings.strings[k].len;
+    }
+
+    TokFileHeader* hp = (TokFileHeader*)base;
+    hp->image_len = total;
+    hp->checksum = image_checksum(base, total);
+
+    out->len = total;
+    free(values);
+    intern_free(&strings);
+    return 1;
+}
+
+int tokfile_write(const char* path, const StrBuf* image) {
+    return write_file_atomic(path, image->data, image->len);
+}
+
+/* ----------------------------
+   Loading
+   ---------------------------- */
+
+static int view_validate(TokFileView* v) {
+    const uint8_t* base = v->file.data;
+    size_t size = v->file.size;
+    if (size < sizeof(TokFileHeader)) return 0;
+
+    const TokFileHeader* h = (const TokFileHeader*)base;
+    if (h->magic != TOKFILE_MAGIC || h->version != TOKFILE_VERSION) return 0;
+    if (h->image_len != size || size % 8 != 0) return 0;
+    if (h->token_count > size || h->string_count > size || h->strings_len > size) return 0;
+
+    for (int s = 0; s < TOKFILE_SEC_COUNT; s++) {
+        uint64_t count = s == TOKFILE_SEC_STR_DATA ? h->strings_len
+                       : (s == TOKFILE_SEC_STR_OFF || s == TOKFILE_SEC_STR_LEN) ? h->string_count
+                       : h->token_count;
+        uint64_t off = h->sections[s];
+        if (off % 8 != 0 || off > size || count * SECTION_ELEM_SIZE[s] > size - off) return 0;
+    }
+
+    v->header = h;
+    v->count = (size_t)h->token_count;
+    v->type = base + h->sections[TOKFILE_SEC_TYPE];
+    v->start_index = (const uint32_t*)(base + h->sections[TOKFILE_SEC_START_INDEX]);
+    v->start_line = (const uint32_t*)(base + h->sections[TOKFILE_SEC_START_LINE]);
+    v->start_col = (const uint32_t*)(base + h->sections[TOKFILE_SEC_START_COL]);
+    v->end_index = (const uint32_t*)(base + h->sections[TOKFILE_SEC_END_INDEX]);
+    v->end_line = (const uint32_t*)(base + h->sections[TOKFILE_SEC_END_LINE]);
+    v->end_col = (const uint32_t*)(base + h->sections[TOKFILE_SEC_END_COL]);
+    v->value = (const uint64_t*)(base + h->sections[TOKFILE_SEC_VALUE]);
+    v->str_off = (const uint32_t*)(base + h->sections[TOKFILE_SEC_STR_OFF]);
+    v->str_len = (const uint32_t*)(base + h->sections[TOKFILE_SEC_STR_LEN]);
+    v->str_data = (const char*)(base + h->sections[TOKFILE_SEC_STR_DATA]);
+
+    // string table is small next to the token columns; check it once here
+    for (size_t k = 0; k < (size_t)h->string_count; k++) {
+        if ((uint64_t)v->str_off[k] + v->str_len[k] > h->strings_len) return 0;
+    }
+    return 1;
+}
+
+int tokfile_map(const char* path, TokFileView* out) {
+    memset(out, 0, sizeof(*out));
+    if (!map_file(path, &out->file)) return 0;
+
+    if (!view_validate(out)) {
+        tokfile_unmap(out);
+        return 0;
+    }
+    return 1;
+}
+
+void tokfile_unmap(TokFileView* view) {
+    unmap_file(&view->file);
+    memset(view, 0, sizeof(*view));
+}
+
+int tokfile_verify(const TokFileView* view) {
+    // view_validate already pinned image_len to the mapped size
+    return image_checksum(view->file.data, view->file.size) == view->header->checksum;
+}
+
+void tokfile_get(const TokFileView* v, size_t i, Token* out) {
+    memset(out, 0, sizeof(*out));
+    out->type = (TokenType)v->type[i];
+    out->start.index = v->start_index[i];
+    out->start.line = v->start_line[i];
+    out->start.column = v->start_col[i];
+    out->end.index = v->end_index[i];
+    out->end.line = v->end_line[i];
+    out->end.column = v->end_col[i];
+
+    uint64_t value = v->value[i];
+    if (has_payload(out->type)) {
+        // a corrupt index yields an empty payload rather than a wild pointer
+        if (value < v->header->string_count) {
+            out->value.str.ptr = v->str_data + v->str_off[value];
+            out->value.str.len = v->str_len[value];
+        } else {
+            out->value.str.ptr = v->str_data;
+        }
+    } else if (out->type == TOK_FLOAT) {
+        memcpy(&out->value.f, &value, sizeof(double));
+    } else {
+        out->value.i = (int64_t)value;
+    }
+}
+
+int tokfile_to_buffer(const TokFileView* v, TokenBuffer* tb) {
+    size_t n = v->count;
+    size_t sbytes = (size_t)v->header->strings_len;
+
+    Token* items = (Token*)malloc((n ? n : 1) * sizeof(Token));
+    char* arena = (char*)malloc(sbytes + 1);
+    if (!items || !arena) {
+        free(items);
+        free(arena);
+        return 0;
+    }
+    STATS_ALLOC(n * sizeof(Token) + sbytes + 1);
+
+    memcpy(arena, v->str_data, sbytes);
+    arena[sbytes] = '\0';
+
+    for (size_t k = 0; k < n; k++) {
+        tokfile_get(v, k, &items[k]);
+        if (has_payload(items[k].type)) {
+            items[k].value.str.ptr = arena + (items[k].value.str.ptr - v->str_data);
+        }
+    }
+
+    token_buffer_free(tb);
+    tb->items = items;
+    tb->count = n;
+    tb->cap = n;
+    tb->string_arena = arena;
+    return 1;
+}
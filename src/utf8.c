@@ -4,6 +4,15 @@
 
 
 #include "utf8.h"
+#include "stats.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF8_SSE2 1
+#include <emmintrin.h>
+#endif
 
 static int is_cont(uint8_t b) {
     return (b & 0xC0u) == 0x80u; // 10xxxxxx
@@ -75,4 +84,168 @@ Utf8Status utf8_next(const uint8_t* buf, size_t len, size_t* i, uint32_t* out_cp
     *i += need;
     return UTF8_OK;
 
-}
\ No newline at end of file
+}
+
+size_t utf8_encode(uint32_t cp, uint8_t* out) {
+    if (cp <= 0x7Fu) {
+        out[0] = (uint8_t)cp;
+        return 1;
+    }
+    if (cp <= 0x7FFu) {
+        out[0] = (uint8_t)(0xC0u | ((cp >> 6) & 0x1Fu));
+        out[1] = (uint8_t)(0x80u | (cp & 0x3Fu));
+        return 2;
+    }
+    if (cp <= 0xFFFFu) {
+        out[0] = (uint8_t)(0xE0u | ((cp >> 12) & 0x0Fu));
+        out[1] = (uint8_t)(0x80u | ((cp >> 6) & 0x3Fu));
+        out[2] = (uint8_t)(0x80u | (cp & 0x3Fu));
+        return 3;
+    }
+    out[0] = (uint8_t)(0xF0u | ((cp >> 18) & 0x07u));
+    out[1] = (uint8_t)(0x80u | ((cp >> 12) & 0x3Fu));
+    out[2] = (uint8_t)(0x80u | ((cp >> 6) & 0x3Fu));
+    out[3] = (uint8_t)(0x80u | (cp & 0x3Fu));
+    return 4;
+}
+
+/* ----------------------------
+   Counting
+   ---------------------------- */
+
+static unsigned popcount16(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_popcount(mask);
+#else
+    unsigned n = 0;
+    for (; mask; mask &= mask - 1) n++;
+    return n;
+#endif
+}
+
+#ifdef UTF8_SSE2
+// code points starting in s[0..16): lead and ASCII bytes are > -65 as signed chars
+static size_t count16(const uint8_t* s) {
+    __m128i v = _mm_loadu_si128((const __m128i*)s);
+    return popcount16((unsigned)_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(-65))));
+}
+#else
+static size_t count16(const uint8_t* s) {
+    size_t n = 0;
+    for (int k = 0; k < 16; k++) n += !is_cont(s[k]);
+    return n;
+}
+#endif
+
+size_t utf8_count(const uint8_t* buf, size_t len) {
+    size_t count = 0, k = 0;
+    for (; k + 16 <= len; k += 16) count += count16(buf + k);
+    for (; k < len; k++) count += !is_cont(buf[k]);
+    return count;
+}
+
+int utf8_is_ascii(const uint8_t* buf, size_t len) {
+    size_t k = 0;
+#ifdef UTF8_SSE2
+    __m128i any = _mm_setzero_si128();
+    for (; k + 16 <= len; k += 16) any = _mm_or_si128(any, _mm_loadu_si128((const __m128i*)(buf + k)));
+    if (_mm_movemask_epi8(any)) return 0;
+#endif
+    for (; k < len; k++) {
+        if (buf[k] & 0x80u) return 0;
+    }
+    return 1;
+}
+
+/* ----------------------------
+   Breadcrumb index
+   ---------------------------- */
+
+void utf8_index_init(Utf8Index* ix, const uint8_t* data, size_t len) {
+    memset(ix, 0, sizeof(*ix));
+    ix->data = data;
+    ix->len = len;
+}
+
+void utf8_index_free(Utf8Index* ix) {
+    free(ix->crumbs);
+    ix->crumbs = NULL;
+    ix->built = 0;
+}
+
+static int index_build(Utf8Index* ix) {
+    if (ix->built) return 1;
+
+    const uint8_t* s = ix->data;
+    size_t len = ix->len;
+    if (utf8_is_ascii(s, len)) {
+        ix->ascii = 1;
+        ix->count = len;
+        ix->built = 1;
+        return 1;
+    }
+
+    size_t max_crumbs = len / UTF8_CRUMB_STRIDE + 1; // count <= len
+    ix->crumbs = (size_t*)malloc(max_crumbs * sizeof(size_t));
+    if (!ix->crumbs) return 0;
+    STATS_ALLOC(max_crumbs * sizeof(size_t));
+
+    // count whole chunks; only walk a chunk byte by byte when a breadcrumb falls inside it
+    size_t cp = 0, nc = 0, k = 0;
+    for (; k + 16 <= len; k += 16) {
+        size_t c = count16(s + k);
+        if (nc * UTF8_CRUMB_STRIDE >= cp + c) {
+            cp += c;
+            continue;
+        }
+        for (size_t j = k; j < k + 16; j++) {
+            if (is_cont(s[j])) continue;
+            if (cp == nc * UTF8_CRUMB_STRIDE) ix->crumbs[nc++] = j;
+            cp++;
+        }
+    }
+    for (; k < len; k++) {
+        if (is_cont(s[k])) continue;
+        if (cp == nc * UTF8_CRUMB_STRIDE) ix->crumbs[nc++] = k;
+        cp++;
+    }
+
+    ix->count = cp;
+    ix->built = 1;
+    return 1;
+}
+
+int utf8_index_length(Utf8Index* ix, size_t* out_count) {
+    if (!index_build(ix)) return 0;
+    *out_count = ix->count;
+    return 1;
+}
+
+int utf8_index_offset(Utf8Index* ix, size_t cp, size_t* out_byte) {
+    if (!index_build(ix) || cp > ix->count) return 0;
+    if (ix->ascii) {
+        *out_byte = cp;
+        return 1;
+    }
+    if (cp == ix->count) {
+        *out_byte = ix->len;
+        return 1;
+    }
+
+    const uint8_t* s = ix->data;
+    size_t at = ix->crumbs[cp / UTF8_CRUMB_STRIDE];
+    for (size_t r = cp % UTF8_CRUMB_STRIDE; r; r--) {
+        at++;
+        while (is_cont(s[at])) at++;
+    }
+    *out_byte = at;
+    return 1;
+}
+
+int utf8_index_slice(Utf8Index* ix, size_t from, size_t to, size_t* out_byte, size_t* out_len) {
+    size_t a = 0, b = 0;
+    if (from > to || !utf8_index_offset(ix, from, &a) || !utf8_index_offset(ix, to, &b)) return 0;
+    *out_byte = a;
+    *out_len = b - a;
+    return 1;
+}